@@ -3,6 +3,7 @@
 
 #include "ApplicationLayer.h"
 #include "Managers/Input.h"
+#include "Utilities/JobSystem.h"
 
 namespace Exelius
 {
@@ -30,6 +31,9 @@ namespace Exelius
 
 		m_logger.LogInfo("Initializing IApplicationLayer.");
 
+		//--------------------Job System Creation--------------------
+		JobSystem::Initialize(m_pSystem->GetNumberCores());
+
 		//--------------------GameLayer Creation--------------------
 		m_pGameLayer = CreateGameLayer();
 		if (m_pGameLayer == nullptr)
@@ -497,6 +497,33 @@ namespace Exelius
             return pTexture;
         }
 
+        virtual bool UpdateTexturePixels(ITexture* pTexture, const std::vector<uint32_t>& pixelMap, unsigned int pitch, const Rectangle& area) final override
+        {
+            if (!pTexture)
+                return false;
+
+            if (area.w <= 0 || area.h <= 0)
+                return true;
+
+            auto& logger = IApplicationLayer::GetInstance()->GetLogger();
+
+            SDL_Texture* pSDLTexture =
+                reinterpret_cast<SDL_Texture*>(pTexture->GetNativeTexture());
+
+            // SDL reads area.h rows of pitch bytes from the area's first pixel.
+            const SDL_Rect rect = { area.x, area.y, area.w, area.h };
+            const uint32_t* pFirstPixel = pixelMap.data() + (size_t)area.y * (pitch / sizeof(uint32_t)) + (size_t)area.x;
+
+            if (SDL_UpdateTexture(pSDLTexture, &rect, pFirstPixel, pitch))
+            {
+                logger.LogDebug("SDL_UpdateTexture has failed: ", false);
+                logger.LogDebug(SDL_GetError());
+                return false;
+            }
+
+            return true;
+        }
+
         virtual bool DrawPixelMap(const std::vector<uint32_t>& pixelMap, bool isInitialRender, unsigned int mapWidth, unsigned int mapHeight, unsigned int pitch) final override
         {
             auto& logger = IApplicationLayer::GetInstance()->GetLogger();
@@ -144,6 +144,17 @@ namespace Exelius
 
 		virtual std::shared_ptr<ITexture> GetTextureFromPixels(const std::vector<uint32_t>& pixelMap, unsigned int mapWidth, unsigned int mapHeight, unsigned int pitch) = 0;
 
+		/// <summary>
+		/// Uploads part of a pixel map to a texture made by GetTextureFromPixels, so a texture that changes
+		/// a little every frame is kept instead of remade.
+		/// </summary>
+		/// <param name="pTexture">(ITexture*) Texture to update, the same size as the pixel map.</param>
+		/// <param name="pixelMap">(const std::vector<uint32_t>&) The whole pixel map.</param>
+		/// <param name="pitch">(unsigned int) Bytes per row of the pixel map.</param>
+		/// <param name="area">(const Rectangle&) The pixels to upload. Only this area of the texture changes.</param>
+		/// <returns>(bool) True if successful, false if not. Logs and errors.</returns>
+		virtual bool UpdateTexturePixels(ITexture* pTexture, const std::vector<uint32_t>& pixelMap, unsigned int pitch, const Rectangle& area) = 0;
+
 		virtual bool DrawPixelMap(const std::vector<uint32_t>& pixelMap, bool isInitialRender = true, unsigned int mapWidth = 0, unsigned int mapHeight = 0, unsigned int pitch = 64 * 4) = 0;
 
 		/// <summary>
@@ -0,0 +1,186 @@
+#pragma once
+#include "Utilities/GridNeighborhood.h"
+#include "Utilities/JobSystem.h"
+#include "Utilities/TraceRecorder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//Exelius Engine namespace. Used for all Engine related code.
+namespace Exelius
+{
+	/// <summary>
+	/// Runs synchronous cellular automata steps over a width x height grid on the job system, for grids where
+	/// only a few cells can change. Every cell of a step sees the grid as it was before the step, so the
+	/// result is the same for any visit order and thread count, but a step only visits the active cells.
+	///
+	/// isActive(pAbove, pRow, pBelow, row, column) says if a cell can change in the next step, from the cell
+	/// and its 4 neighbours. It has to be true for every cell the rule could change, otherwise the result
+	/// differs from stepping every cell. rule(pAbove, pRow, pBelow, row, column) returns the new value of a
+	/// cell. pRow is the cell's row, pAbove/pBelow the rows around it, null on the first/last row. Draw any
+	/// randomness per cell (e.g. Exelius::TileRandom), not from shared state.
+	///
+	/// BeginSteps scans the whole grid once. After that a cell is only looked at again when it or one of
+	/// its neighbours changed, or when it was active and could still change. A step computes the new
+	/// values of every active cell in parallel first, then writes them, so no cell sees a change made in the
+	/// same step.
+	///
+	/// \b Example:
+	/// ~~~~~
+	/// automaton.BeginSteps(cells, width, height, rowsPerJob, isActive);
+	/// for (int i = 0; i < iterations; ++i)
+	///		automaton.Step(cells, width, height, cellsPerJob, isActive, rule);
+	/// ~~~~~
+	/// </summary>
+	template <class Cell>
+	class SparseCellularAutomaton
+	{
+		// Cells that can change in the next step, and their new values during a step.
+		std::vector<size_t> m_activeCells;
+		std::vector<Cell> m_newValues;
+		std::vector<size_t> m_nextActiveCells;
+
+		// 1 for every cell in m_activeCells, one per grid cell.
+		std::vector<uint8_t> m_isActive;
+
+		// Active cells found by each job of BeginSteps, joined in row order.
+		std::vector<std::vector<size_t>> m_blockActiveCells;
+
+	public:
+		/// <summary>
+		/// Find the active cells of cells. Call before the first Step and whenever cells was changed
+		/// outside of Step.
+		/// </summary>
+		template <class IsActive>
+		void BeginSteps(const std::vector<Cell>& cells, size_t width, size_t height, size_t rowsPerJob, const IsActive& isActive)
+		{
+			if (rowsPerJob == 0)
+				rowsPerJob = 1;
+
+			m_isActive.assign(cells.size(), 0);
+			m_activeCells.clear();
+
+			const size_t numBlocks = (height + rowsPerJob - 1) / rowsPerJob;
+			m_blockActiveCells.resize(numBlocks);
+
+			const Cell* pCells = cells.data();
+			uint8_t* pIsActive = m_isActive.data();
+			std::vector<size_t>* pBlockActiveCells = m_blockActiveCells.data();
+
+			JobSystem::GetInstance().ParallelFor(0, numBlocks, 1, [=, &isActive](size_t firstBlock, size_t endBlock)
+			{
+				EXELIUS_TRACE_SCOPE("SparseCellularAutomaton::BeginSteps");
+				for (size_t block = firstBlock; block < endBlock; ++block)
+				{
+					std::vector<size_t>& blockActiveCells = pBlockActiveCells[block];
+					blockActiveCells.clear();
+
+					const size_t endRow = (block + 1) * rowsPerJob < height ? (block + 1) * rowsPerJob : height;
+					for (size_t row = block * rowsPerJob; row < endRow; ++row)
+					{
+						const Cell* pRow = pCells + row * width;
+						const Cell* pAbove = (row > 0) ? pRow - width : nullptr;
+						const Cell* pBelow = (row + 1 < height) ? pRow + width : nullptr;
+
+						for (size_t column = 0; column < width; ++column)
+						{
+							if (isActive(pAbove, pRow, pBelow, row, column))
+							{
+								pIsActive[row * width + column] = 1;
+								blockActiveCells.push_back(row * width + column);
+							}
+						}
+					}
+				}
+			});
+
+			for (const std::vector<size_t>& blockActiveCells : m_blockActiveCells)
+			{
+				m_activeCells.insert(m_activeCells.end(), blockActiveCells.begin(), blockActiveCells.end());
+			}
+		}
+
+		/// <summary>
+		/// Run one step of rule over the active cells of cells, then find the cells that are active next.
+		/// </summary>
+		template <class IsActive, class Rule>
+		void Step(std::vector<Cell>& cells, size_t width, size_t height, size_t cellsPerJob, const IsActive& isActive, const Rule& rule)
+		{
+			const size_t numActive = m_activeCells.size();
+			m_newValues.resize(numActive);
+
+			const Cell* pCells = cells.data();
+			const size_t* pActiveCells = m_activeCells.data();
+			Cell* pNewValues = m_newValues.data();
+
+			JobSystem::GetInstance().ParallelFor(0, numActive, cellsPerJob, [=, &rule](size_t first, size_t end)
+			{
+				EXELIUS_TRACE_SCOPE("SparseCellularAutomaton::Step");
+				for (size_t i = first; i < end; ++i)
+				{
+					const size_t row = pActiveCells[i] / width;
+					const Cell* pRow = pCells + row * width;
+					const Cell* pAbove = (row > 0) ? pRow - width : nullptr;
+					const Cell* pBelow = (row + 1 < height) ? pRow + width : nullptr;
+
+					pNewValues[i] = rule(pAbove, pRow, pBelow, row, pActiveCells[i] - row * width);
+				}
+			});
+
+			// Every new value is known, so they can be written now. pNewValues keeps the old value of a
+			// changed cell.
+			for (size_t i = 0; i < numActive; ++i)
+			{
+				m_isActive[pActiveCells[i]] = 0;
+				if (cells[pActiveCells[i]] != pNewValues[i])
+					std::swap(cells[pActiveCells[i]], pNewValues[i]);
+			}
+
+			// A cell that didn't change can only stay active. A cell that changed can make its neighbours
+			// active too.
+			m_nextActiveCells.clear();
+			for (size_t i = 0; i < numActive; ++i)
+			{
+				const size_t index = pActiveCells[i];
+				Activate(cells, width, height, index, isActive);
+
+				if (cells[index] == pNewValues[i])
+					continue;
+
+				for (size_t neighbor : GetNeighbors4(index, width, height))
+					Activate(cells, width, height, neighbor, isActive);
+			}
+
+			std::swap(m_activeCells, m_nextActiveCells);
+		}
+
+		/// <summary>
+		/// Number of cells the next Step visits.
+		/// </summary>
+		size_t GetActiveCount() const { return m_activeCells.size(); }
+
+	private:
+		/// <summary>
+		/// Add a cell to the active cells of the next step if it isn't already and isActive says so.
+		/// </summary>
+		template <class IsActive>
+		void Activate(const std::vector<Cell>& cells, size_t width, size_t height, size_t index, const IsActive& isActive)
+		{
+			if (m_isActive[index])
+				return;
+
+			const size_t row = index / width;
+			const Cell* pRow = cells.data() + row * width;
+			const Cell* pAbove = (row > 0) ? pRow - width : nullptr;
+			const Cell* pBelow = (row + 1 < height) ? pRow + width : nullptr;
+
+			if (isActive(pAbove, pRow, pBelow, row, index - row * width))
+			{
+				m_isActive[index] = 1;
+				m_nextActiveCells.push_back(index);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,303 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+//Exelius Engine namespace. Used for all Engine related code.
+namespace Exelius
+{
+	/// <summary>
+	/// The in-bounds neighbours of one cell of a width x height grid (cells row by row), as cell indices.
+	/// Held inline, so making one doesn't allocate. Neighbours past the edge of the grid are left out, an
+	/// edge cell has fewer than kMaxNeighbors.
+	///
+	/// Use GetNeighbors4 / GetNeighbors8 to make one. Iterate it like a container:
+	/// ~~~~~
+	/// for (size_t neighbor : GetNeighbors4(index, width, height))
+	///		...
+	/// ~~~~~
+	/// </summary>
+	template <size_t kMaxNeighbors>
+	class GridNeighbors
+	{
+		size_t m_indices[kMaxNeighbors];
+		size_t m_count;
+
+	public:
+		GridNeighbors()
+			: m_count(0)
+		{
+			//
+		}
+
+		void Add(size_t index) { m_indices[m_count++] = index; }
+
+		const size_t* begin() const { return m_indices; }
+		const size_t* end() const { return m_indices + m_count; }
+		size_t size() const { return m_count; }
+		bool empty() const { return m_count == 0; }
+		size_t operator[](size_t i) const { return m_indices[i]; }
+	};
+
+	using GridNeighbors4 = GridNeighbors<4>;
+	using GridNeighbors8 = GridNeighbors<8>;
+
+	/// <summary>
+	/// The 4-connected neighbours of a cell, in the order left, right, top, bottom.
+	/// </summary>
+	inline GridNeighbors4 GetNeighbors4(size_t index, size_t width, size_t height)
+	{
+		assert(index < width * height && "GetNeighbors4 on a cell outside the grid.");
+
+		const size_t column = index % width;
+		const size_t row = index / width;
+
+		GridNeighbors4 neighbors;
+		if (column > 0)
+			neighbors.Add(index - 1);
+		if (column + 1 < width)
+			neighbors.Add(index + 1);
+		if (row > 0)
+			neighbors.Add(index - width);
+		if (row + 1 < height)
+			neighbors.Add(index + width);
+		return neighbors;
+	}
+
+	/// <summary>
+	/// The 8-connected neighbours of a cell, row by row: the three above, left, right, then the three below.
+	/// </summary>
+	inline GridNeighbors8 GetNeighbors8(size_t index, size_t width, size_t height)
+	{
+		assert(index < width * height && "GetNeighbors8 on a cell outside the grid.");
+
+		const size_t column = index % width;
+		const size_t row = index / width;
+		const bool hasLeft = (column > 0);
+		const bool hasRight = (column + 1 < width);
+
+		GridNeighbors8 neighbors;
+		if (row > 0)
+		{
+			const size_t above = index - width;
+			if (hasLeft)
+				neighbors.Add(above - 1);
+			neighbors.Add(above);
+			if (hasRight)
+				neighbors.Add(above + 1);
+		}
+
+		if (hasLeft)
+			neighbors.Add(index - 1);
+		if (hasRight)
+			neighbors.Add(index + 1);
+
+		if (row + 1 < height)
+		{
+			const size_t below = index + width;
+			if (hasLeft)
+				neighbors.Add(below - 1);
+			neighbors.Add(below);
+			if (hasRight)
+				neighbors.Add(below + 1);
+		}
+		return neighbors;
+	}
+
+	/// <summary>
+	/// A 3x3 window of cells around one cell of a grid: the rows above, at and below the cell, which is the
+	/// same shape SparseCellularAutomaton passes its rules (pAbove/pBelow null on the first/last row).
+	/// Reading a neighbour is one pointer offset, check Has* first on edge cells. A diagonal is only there
+	/// when both of its sides are, HasTopLeft and friends check that.
+	/// </summary>
+	template <class Cell>
+	class GridStencil
+	{
+		const Cell* m_pAbove;
+		const Cell* m_pRow;
+		const Cell* m_pBelow;
+		size_t m_width;
+		size_t m_row;
+		size_t m_column;
+
+		template <class> friend class GridStencilRange;
+
+	public:
+		GridStencil(const Cell* pAbove, const Cell* pRow, const Cell* pBelow, size_t width, size_t row, size_t column)
+			: m_pAbove(pAbove)
+			, m_pRow(pRow)
+			, m_pBelow(pBelow)
+			, m_width(width)
+			, m_row(row)
+			, m_column(column)
+		{
+			//
+		}
+
+		size_t GetRow() const { return m_row; }
+		size_t GetColumn() const { return m_column; }
+		size_t GetIndex() const { return m_row * m_width + m_column; }
+
+		bool HasLeft() const { return m_column > 0; }
+		bool HasRight() const { return m_column + 1 < m_width; }
+		bool HasTop() const { return m_pAbove != nullptr; }
+		bool HasBottom() const { return m_pBelow != nullptr; }
+		bool HasTopLeft() const { return HasTop() && HasLeft(); }
+		bool HasTopRight() const { return HasTop() && HasRight(); }
+		bool HasBottomLeft() const { return HasBottom() && HasLeft(); }
+		bool HasBottomRight() const { return HasBottom() && HasRight(); }
+
+		const Cell& GetCenter() const { return m_pRow[m_column]; }
+		const Cell& GetLeft() const { return m_pRow[m_column - 1]; }
+		const Cell& GetRight() const { return m_pRow[m_column + 1]; }
+		const Cell& GetTop() const { return m_pAbove[m_column]; }
+		const Cell& GetBottom() const { return m_pBelow[m_column]; }
+		const Cell& GetTopLeft() const { return m_pAbove[m_column - 1]; }
+		const Cell& GetTopRight() const { return m_pAbove[m_column + 1]; }
+		const Cell& GetBottomLeft() const { return m_pBelow[m_column - 1]; }
+		const Cell& GetBottomRight() const { return m_pBelow[m_column + 1]; }
+
+		/// <summary>
+		/// The cell's neighbours as grid indices, in the same order as Exelius::GetNeighbors4.
+		/// </summary>
+		GridNeighbors4 GetNeighbors4() const
+		{
+			const size_t index = GetIndex();
+
+			GridNeighbors4 neighbors;
+			if (HasLeft())
+				neighbors.Add(index - 1);
+			if (HasRight())
+				neighbors.Add(index + 1);
+			if (HasTop())
+				neighbors.Add(index - m_width);
+			if (HasBottom())
+				neighbors.Add(index + m_width);
+			return neighbors;
+		}
+
+		/// <summary>
+		/// The cell's 8-connected neighbours as grid indices, in the same order as Exelius::GetNeighbors8.
+		/// </summary>
+		GridNeighbors8 GetNeighbors8() const
+		{
+			const size_t index = GetIndex();
+
+			GridNeighbors8 neighbors;
+			if (HasTopLeft())
+				neighbors.Add(index - m_width - 1);
+			if (HasTop())
+				neighbors.Add(index - m_width);
+			if (HasTopRight())
+				neighbors.Add(index - m_width + 1);
+			if (HasLeft())
+				neighbors.Add(index - 1);
+			if (HasRight())
+				neighbors.Add(index + 1);
+			if (HasBottomLeft())
+				neighbors.Add(index + m_width - 1);
+			if (HasBottom())
+				neighbors.Add(index + m_width);
+			if (HasBottomRight())
+				neighbors.Add(index + m_width + 1);
+			return neighbors;
+		}
+	};
+
+	/// <summary>
+	/// Every cell of a rectangle of a grid as a GridStencil, row by row. Stepping to the next cell moves the
+	/// stencil one column and only recomputes the row pointers on a new row.
+	/// ~~~~~
+	/// for (const GridStencil<BiomeId>& tile : GridStencilRange<BiomeId>(biomes.data(), width, height, 0, height, 0, width))
+	///		if (tile.HasTop() && tile.GetTop() == BiomeId::kOcean)
+	///			...
+	/// ~~~~~
+	/// </summary>
+	template <class Cell>
+	class GridStencilRange
+	{
+		const Cell* m_pCells;
+		size_t m_width;
+		size_t m_height;
+		size_t m_firstRow;
+		size_t m_endRow;
+		size_t m_firstColumn;
+		size_t m_endColumn;
+
+	public:
+		class Iterator
+		{
+			GridStencil<Cell> m_stencil;
+			const Cell* m_pCells;
+			size_t m_height;
+			size_t m_firstColumn;
+			size_t m_endColumn;
+
+		public:
+			Iterator(const Cell* pCells, size_t width, size_t height, size_t row, size_t firstColumn, size_t endColumn)
+				: m_stencil(nullptr, nullptr, nullptr, width, row, firstColumn)
+				, m_pCells(pCells)
+				, m_height(height)
+				, m_firstColumn(firstColumn)
+				, m_endColumn(endColumn)
+			{
+				SetRow(row);
+			}
+
+			const GridStencil<Cell>& operator*() const { return m_stencil; }
+			const GridStencil<Cell>* operator->() const { return &m_stencil; }
+
+			Iterator& operator++()
+			{
+				if (++m_stencil.m_column == m_endColumn)
+				{
+					m_stencil.m_column = m_firstColumn;
+					SetRow(m_stencil.m_row + 1);
+				}
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const { return m_stencil.m_row == other.m_stencil.m_row && m_stencil.m_column == other.m_stencil.m_column; }
+			bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+		private:
+			void SetRow(size_t row)
+			{
+				m_stencil.m_row = row;
+				if (row >= m_height)
+					return;
+
+				const size_t width = m_stencil.m_width;
+				m_stencil.m_pRow = m_pCells + row * width;
+				m_stencil.m_pAbove = (row > 0) ? m_stencil.m_pRow - width : nullptr;
+				m_stencil.m_pBelow = (row + 1 < m_height) ? m_stencil.m_pRow + width : nullptr;
+			}
+		};
+
+		/// <summary>
+		/// Cells [firstColumn, endColumn) of rows [firstRow, endRow) of a width x height grid. The rectangle
+		/// is cut off at the grid edge; a rectangle with nothing left in it is an empty range.
+		/// </summary>
+		GridStencilRange(const Cell* pCells, size_t width, size_t height, size_t firstRow, size_t endRow, size_t firstColumn, size_t endColumn)
+			: m_pCells(pCells)
+			, m_width(width)
+			, m_height(height)
+			, m_firstRow(firstRow)
+			, m_endRow(std::min(endRow, height))
+			, m_firstColumn(firstColumn)
+			, m_endColumn(std::min(endColumn, width))
+		{
+			// An empty range starts at its end, and begin() must never be past end().
+			if (m_firstRow >= m_endRow || m_firstColumn >= m_endColumn)
+			{
+				m_firstRow = 0;
+				m_endRow = 0;
+				m_firstColumn = 0;
+				m_endColumn = 0;
+			}
+		}
+
+		Iterator begin() const { return Iterator(m_pCells, m_width, m_height, m_firstRow, m_firstColumn, m_endColumn); }
+		Iterator end() const { return Iterator(m_pCells, m_width, m_height, m_endRow, m_firstColumn, m_endColumn); }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "JobSystem.h"
+#include "TraceRecorder.h"
+
+#include <cassert>
+#include <string>
+
+namespace Exelius
+{
+	std::unique_ptr<JobSystem> JobSystem::s_pInstance = nullptr;
+
+	// The job system the calling thread is a worker of, and its index there.
+	static thread_local const JobSystem* s_pWorkerOwner = nullptr;
+	static thread_local unsigned int s_workerIndex = 0;
+
+	// How many ParallelFor calls the calling thread is inside of, while it is not a worker.
+	static thread_local unsigned int s_sharedQueueDepth = 0;
+
+	JobSystem::JobSystem(unsigned int numThreads)
+		: m_queuedJobs(0)
+		, m_sharedQueueOwner(std::thread::id())
+		, m_queuedTasks(0)
+		, m_stopping(false)
+	{
+		if (numThreads == 0)
+			numThreads = 1;
+
+		for (unsigned int i = 0; i < numThreads; ++i)
+		{
+			m_queues.emplace_back(std::make_unique<WorkQueue>());
+		}
+
+		m_workers.reserve((size_t)numThreads - 1);
+		for (unsigned int i = 0; i + 1 < numThreads; ++i)
+		{
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_stopping = true;
+		}
+		m_wakeCondition.notify_all();
+
+		for (std::thread& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	void JobSystem::Initialize(unsigned int numThreads)
+	{
+		s_pInstance = nullptr;
+		s_pInstance = std::make_unique<JobSystem>(numThreads);
+	}
+
+	JobSystem& JobSystem::GetInstance()
+	{
+		// The first call may come from any thread. A function-local static is initialised exactly once,
+		// and every other caller waits for it.
+		static const bool s_isCreated = []()
+		{
+			if (!s_pInstance)
+				s_pInstance = std::make_unique<JobSystem>(std::thread::hardware_concurrency());
+			return true;
+		}();
+		(void)s_isCreated;
+
+		return *s_pInstance;
+	}
+
+	unsigned int JobSystem::GetCurrentThreadIndex() const
+	{
+		if (s_pWorkerOwner == this)
+			return s_workerIndex;
+
+		return (unsigned int)m_workers.size();
+	}
+
+	void JobSystem::Push(const Job& job)
+	{
+		WorkQueue& queue = *m_queues[GetCurrentThreadIndex()];
+		{
+			std::lock_guard<std::mutex> lock(queue.m_mutex);
+			queue.m_jobs.push_back(job);
+		}
+
+		m_queuedJobs.fetch_add(1, std::memory_order_release);
+		WakeWorker();
+	}
+
+	void JobSystem::EnterParallelFor(unsigned int threadIndex)
+	{
+#ifndef NDEBUG
+		if (threadIndex != m_workers.size() || s_sharedQueueDepth++ > 0)
+			return;
+
+		// Both threads would push to and pop from the same queue, and share per-thread scratch.
+		std::thread::id noOwner;
+		const bool isOnlyCaller = m_sharedQueueOwner.compare_exchange_strong(noOwner, std::this_thread::get_id());
+		assert(isOnlyCaller && "Two threads that aren't job system workers ran a ParallelFor at the same time.");
+		(void)isOnlyCaller;
+#else
+		(void)threadIndex;
+#endif
+	}
+
+	void JobSystem::LeaveParallelFor(unsigned int threadIndex)
+	{
+#ifndef NDEBUG
+		if (threadIndex != m_workers.size() || --s_sharedQueueDepth > 0)
+			return;
+
+		m_sharedQueueOwner.store(std::thread::id(), std::memory_order_release);
+#else
+		(void)threadIndex;
+#endif
+	}
+
+	void JobSystem::PushTask(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_taskMutex);
+			m_tasks.push_back(std::move(task));
+		}
+
+		m_queuedTasks.fetch_add(1, std::memory_order_release);
+		WakeWorker();
+	}
+
+	void JobSystem::WakeWorker()
+	{
+		// Taking the lock orders this with a worker that is about to sleep, so the wake is not lost.
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_wakeCondition.notify_one();
+	}
+
+	bool JobSystem::RunQueuedJob(unsigned int threadIndex)
+	{
+		if (m_queuedJobs.load(std::memory_order_acquire) == 0)
+			return false;
+
+		const size_t numQueues = m_queues.size();
+		for (size_t offset = 0; offset < numQueues; ++offset)
+		{
+			const size_t queueIndex = (threadIndex + offset) % numQueues;
+			WorkQueue& queue = *m_queues[queueIndex];
+
+			Job job;
+			{
+				std::lock_guard<std::mutex> lock(queue.m_mutex);
+				if (queue.m_jobs.empty())
+					continue;
+
+				// Own queue: newest job, it is still warm in cache. Other queues: oldest job, the biggest piece.
+				if (offset == 0)
+				{
+					job = queue.m_jobs.back();
+					queue.m_jobs.pop_back();
+				}
+				else
+				{
+					job = queue.m_jobs.front();
+					queue.m_jobs.pop_front();
+				}
+			}
+
+			m_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+			job.m_pRun(*this, job);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool JobSystem::RunSubmittedTask()
+	{
+		if (m_queuedTasks.load(std::memory_order_acquire) == 0)
+			return false;
+
+		std::function<void()> task;
+		{
+			std::lock_guard<std::mutex> lock(m_taskMutex);
+			if (m_tasks.empty())
+				return false;
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+
+		m_queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+		task();
+		return true;
+	}
+
+	void JobSystem::WorkerLoop(unsigned int threadIndex)
+	{
+		s_pWorkerOwner = this;
+		s_workerIndex = threadIndex;
+		TraceRecorder::GetInstance().SetCurrentThreadName("Job worker " + std::to_string(threadIndex));
+
+		for (;;)
+		{
+			// ParallelFor jobs first, a thread is waiting on those.
+			if (RunQueuedJob(threadIndex) || RunSubmittedTask())
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wakeCondition.wait(lock, [this]()
+			{
+				return m_stopping || m_queuedJobs.load(std::memory_order_acquire) > 0 || m_queuedTasks.load(std::memory_order_acquire) > 0;
+			});
+
+			if (m_stopping && m_queuedJobs.load(std::memory_order_acquire) == 0 && m_queuedTasks.load(std::memory_order_acquire) == 0)
+				return;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Exelius Engine namespace. Used for all Engine related code.
+namespace Exelius
+{
+	/// <summary>
+	/// Persistent pool of worker threads for data parallel work like map generation.
+	///
+	/// Every thread owns a deque of jobs. A thread runs its newest job first, and a thread that runs out of
+	/// work steals the oldest job of another thread. ParallelFor splits its range in halves down to the grain
+	/// size as it goes, so the oldest job is always the largest piece left, and parts of a map that take
+	/// longer end up split over more threads.
+	///
+	/// The thread that calls ParallelFor works on the range as well and returns once all of it is done, so
+	/// ParallelFor can also be called from inside a job.
+	///
+	/// Work nobody should wait for (generating a world chunk while the game keeps drawing) goes to Submit
+	/// instead. Those tasks only ever run on workers, when they have no ParallelFor jobs left.
+	///
+	/// \b Example:
+	/// ~~~~~
+	/// JobSystem::GetInstance().ParallelFor(0, tileCount, 4096, [&](size_t begin, size_t end)
+	/// {
+	///		for (size_t i = begin; i < end; ++i)
+	///			...
+	/// });
+	/// ~~~~~
+	/// </summary>
+	class JobSystem
+	{
+		/// <summary>
+		/// A piece of work: pRun is called with the context and the range [begin, end).
+		/// </summary>
+		struct Job
+		{
+			void (*m_pRun)(JobSystem& jobSystem, const Job& job);
+			void* m_pContext;
+			size_t m_begin;
+			size_t m_end;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex m_mutex;
+			std::deque<Job> m_jobs;
+		};
+
+		template <class Function>
+		struct RangeContext
+		{
+			const Function* m_pFunction;
+			size_t m_grainSize;
+
+			// Items of the range that have not finished yet.
+			std::atomic<size_t> m_remaining;
+		};
+
+		static std::unique_ptr<JobSystem> s_pInstance;
+
+		std::vector<std::thread> m_workers;
+
+		// One queue per worker, plus the last one for every thread that is not a worker.
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+		// Jobs that are queued and not yet picked up by any thread.
+		std::atomic<size_t> m_queuedJobs;
+
+		// The thread that isn't a worker and is in a ParallelFor, if any. Only checked in debug builds.
+		std::atomic<std::thread::id> m_sharedQueueOwner;
+
+		// Submitted tasks no worker has picked up yet, oldest first.
+		std::mutex m_taskMutex;
+		std::deque<std::function<void()>> m_tasks;
+		std::atomic<size_t> m_queuedTasks;
+
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeCondition;
+		bool m_stopping;
+
+	public:
+		/// <summary>
+		/// Starts numThreads - 1 workers. The thread calling ParallelFor is the last thread.
+		/// </summary>
+		/// <param name="numThreads">(unsigned int) Threads that work on a ParallelFor. 0 is treated as 1.</param>
+		explicit JobSystem(unsigned int numThreads);
+
+		/// <summary>
+		/// Runs the jobs and submitted tasks that are left, then joins the workers.
+		/// </summary>
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+
+		/// <summary>
+		/// Creates the engine job system with the given thread count (usually ISystem::GetNumberCores).
+		/// Must not be called while the job system is running jobs.
+		/// </summary>
+		/// <param name="numThreads">(unsigned int) Threads that work on a ParallelFor.</param>
+		static void Initialize(unsigned int numThreads);
+
+		/// <summary>
+		/// Get the engine job system. If Initialize was never called, it is created with one thread per
+		/// hardware thread, so tools without an application layer can use it too. Safe to call from
+		/// several threads; Initialize is not, it must run on the main thread before any job is queued.
+		/// </summary>
+		/// <returns>(JobSystem&) The engine job system.</returns>
+		static JobSystem& GetInstance();
+
+		/// <summary>
+		/// Number of threads that work on a ParallelFor, including the calling thread.
+		/// </summary>
+		/// <returns>(unsigned int) Worker count + 1.</returns>
+		unsigned int GetThreadCount() const { return (unsigned int)m_workers.size() + 1; }
+
+		/// <summary>
+		/// Index of the calling thread in [0, GetThreadCount()). Workers have their own index, every other
+		/// thread gets GetThreadCount() - 1, so only one thread that isn't a worker may be in a ParallelFor
+		/// at a time (debug builds assert). Useful for per-thread scratch inside a job.
+		/// </summary>
+		/// <returns>(unsigned int) The index of the calling thread.</returns>
+		unsigned int GetCurrentThreadIndex() const;
+
+		/// <summary>
+		/// Calls function(chunkBegin, chunkEnd) over [begin, end) in chunks of at most grainSize items,
+		/// spread over every thread. Returns when every chunk is done.
+		/// </summary>
+		/// <param name="begin">(size_t) First item of the range.</param>
+		/// <param name="end">(size_t) One past the last item of the range.</param>
+		/// <param name="grainSize">(size_t) Largest chunk a single call gets.</param>
+		/// <param name="function">(const Function&) Called as function(size_t chunkBegin, size_t chunkEnd), from any thread.</param>
+		template <class Function>
+		void ParallelFor(size_t begin, size_t end, size_t grainSize, const Function& function)
+		{
+			if (end <= begin)
+				return;
+
+			if (grainSize == 0)
+				grainSize = 1;
+
+			if (m_workers.empty() || end - begin <= grainSize)
+			{
+				function(begin, end);
+				return;
+			}
+
+			const unsigned int threadIndex = GetCurrentThreadIndex();
+			EnterParallelFor(threadIndex);
+
+			RangeContext<Function> context{ &function, grainSize, { end - begin } };
+			RunRange<Function>(*this, Job{ &RunRange<Function>, &context, begin, end });
+
+			// Help with whatever is queued (this range or any other) until the range is done.
+			while (context.m_remaining.load(std::memory_order_acquire) > 0)
+			{
+				if (!RunQueuedJob(threadIndex))
+					std::this_thread::yield();
+			}
+
+			LeaveParallelFor(threadIndex);
+		}
+
+		/// <summary>
+		/// Run task() once on a worker and return right away. Tasks start in the order they were submitted,
+		/// whenever a worker has no ParallelFor jobs to run, and a task can run a ParallelFor of its own.
+		///
+		/// Nothing waits for a task, so it has to signal when it is done, and everything it uses has to
+		/// outlive it. With a single thread there are no workers, and the task runs before Submit returns.
+		/// </summary>
+		/// <param name="task">(Task&&) Called as task(), on a worker.</param>
+		template <class Task>
+		void Submit(Task&& task)
+		{
+			if (m_workers.empty())
+			{
+				task();
+				return;
+			}
+
+			PushTask(std::function<void()>(std::forward<Task>(task)));
+		}
+
+	private:
+		template <class Function>
+		static void RunRange(JobSystem& jobSystem, const Job& job)
+		{
+			RangeContext<Function>& context = *static_cast<RangeContext<Function>*>(job.m_pContext);
+
+			// Split off the upper half until the rest is one chunk. The split off halves are what other
+			// threads steal.
+			size_t begin = job.m_begin;
+			size_t end = job.m_end;
+			while (end - begin > context.m_grainSize)
+			{
+				const size_t middle = begin + (end - begin) / 2;
+				jobSystem.Push(Job{ &RunRange<Function>, &context, middle, end });
+				end = middle;
+			}
+
+			(*context.m_pFunction)(begin, end);
+
+			// Last access to the context, ParallelFor may return as soon as this hits 0.
+			context.m_remaining.fetch_sub(end - begin, std::memory_order_acq_rel);
+		}
+
+		/// <summary>
+		/// Queue a job on the calling thread's queue and wake a sleeping worker.
+		/// </summary>
+		void Push(const Job& job);
+
+		/// <summary>
+		/// Run one job: the newest of the thread's own queue, or the oldest of another queue.
+		/// </summary>
+		/// <returns>(bool) False if every queue was empty.</returns>
+		bool RunQueuedJob(unsigned int threadIndex);
+
+		void PushTask(std::function<void()> task);
+
+		/// <summary>
+		/// Claim the shared queue for a thread that isn't a worker, asserting no other such thread has it.
+		/// Nested ParallelFor calls on the same thread are fine.
+		/// </summary>
+		void EnterParallelFor(unsigned int threadIndex);
+		void LeaveParallelFor(unsigned int threadIndex);
+
+		/// <summary>
+		/// Run the oldest submitted task.
+		/// </summary>
+		/// <returns>(bool) False if there was none.</returns>
+		bool RunSubmittedTask();
+
+		/// <summary>
+		/// Wake one sleeping worker for newly queued work.
+		/// </summary>
+		void WakeWorker();
+
+		void WorkerLoop(unsigned int threadIndex);
+	};
+}
\ No newline at end of file
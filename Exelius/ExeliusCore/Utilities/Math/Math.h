@@ -32,6 +32,6 @@ namespace Exelius
 
 	static inline float Distance(const Vector2f& pos1, const Vector2f& pos2)
 	{
-		return std::sqrtf(SquareDistance(pos1, pos2));
+		return std::sqrt(SquareDistance(pos1, pos2));
 	}
 }
\ No newline at end of file
@@ -0,0 +1,200 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// Define EXELIUS_SIMD_DISABLE to force the single lane scalar path (useful when validating the wide paths).
+#if !defined(EXELIUS_SIMD_DISABLE)
+	#if defined(__AVX2__)
+		#include <immintrin.h>
+		#define EXELIUS_SIMD_AVX2 1
+	#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#include <emmintrin.h>
+		#define EXELIUS_SIMD_SSE2 1
+	#endif
+#endif
+
+// The lane helpers are tiny and only pay off when they disappear into the calling kernel.
+#if defined(_MSC_VER)
+	#define EXELIUS_SIMD_INLINE __forceinline
+#else
+	#define EXELIUS_SIMD_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace Exelius
+{
+	/// <summary>
+	/// Thin wrapper over the widest instruction set the compiler was told it can use (AVX2, then SSE2,
+	/// then a single scalar "lane"). Kernels are written once against FloatLanes/IntLanes and these free
+	/// functions, and process kLaneCount values per call.
+	///
+	/// Every operation here is an exact IEEE operation so a kernel written in the same order as its
+	/// scalar counterpart produces the same results.
+	/// </summary>
+	namespace Simd
+	{
+#if defined(EXELIUS_SIMD_AVX2)
+		//----------------------------------------------------------------------------------------------------
+		// AVX2 - 8 Lanes
+		//----------------------------------------------------------------------------------------------------
+		static constexpr size_t kLaneCount = 8;
+		using FloatLanes = __m256;
+		using IntLanes = __m256i;
+
+		EXELIUS_SIMD_INLINE FloatLanes SetFloat(float value) { return _mm256_set1_ps(value); }
+		EXELIUS_SIMD_INLINE FloatLanes LoadFloat(const float* pValues) { return _mm256_loadu_ps(pValues); }
+		EXELIUS_SIMD_INLINE void StoreFloat(float* pValues, FloatLanes lanes) { _mm256_storeu_ps(pValues, lanes); }
+		EXELIUS_SIMD_INLINE FloatLanes LaneIndices() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+
+		EXELIUS_SIMD_INLINE FloatLanes Add(FloatLanes a, FloatLanes b) { return _mm256_add_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Sub(FloatLanes a, FloatLanes b) { return _mm256_sub_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Mul(FloatLanes a, FloatLanes b) { return _mm256_mul_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Div(FloatLanes a, FloatLanes b) { return _mm256_div_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Min(FloatLanes a, FloatLanes b) { return _mm256_min_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Max(FloatLanes a, FloatLanes b) { return _mm256_max_ps(a, b); }
+
+		EXELIUS_SIMD_INLINE IntLanes SetInt(uint32_t value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+		EXELIUS_SIMD_INLINE IntLanes LoadInt(const int* pValues) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pValues)); }
+		EXELIUS_SIMD_INLINE void StoreInt(unsigned int* pValues, IntLanes lanes) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(pValues), lanes); }
+		EXELIUS_SIMD_INLINE IntLanes IntLaneIndices() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+		EXELIUS_SIMD_INLINE IntLanes AddInt(IntLanes a, IntLanes b) { return _mm256_add_epi32(a, b); }
+		EXELIUS_SIMD_INLINE IntLanes SubInt(IntLanes a, IntLanes b) { return _mm256_sub_epi32(a, b); }
+		EXELIUS_SIMD_INLINE IntLanes MulInt(IntLanes a, IntLanes b) { return _mm256_mullo_epi32(a, b); }
+		EXELIUS_SIMD_INLINE IntLanes Xor(IntLanes a, IntLanes b) { return _mm256_xor_si256(a, b); }
+		EXELIUS_SIMD_INLINE IntLanes And(IntLanes a, IntLanes b) { return _mm256_and_si256(a, b); }
+		template <int kBits> EXELIUS_SIMD_INLINE IntLanes ShiftRight(IntLanes a) { return _mm256_srli_epi32(a, kBits); }
+		template <int kBits> EXELIUS_SIMD_INLINE IntLanes ShiftLeft(IntLanes a) { return _mm256_slli_epi32(a, kBits); }
+
+		EXELIUS_SIMD_INLINE IntLanes TruncateToInt(FloatLanes a) { return _mm256_cvttps_epi32(a); }
+		EXELIUS_SIMD_INLINE FloatLanes IntToFloat(IntLanes a) { return _mm256_cvtepi32_ps(a); }
+		EXELIUS_SIMD_INLINE IntLanes AsInt(FloatLanes a) { return _mm256_castps_si256(a); }
+
+		EXELIUS_SIMD_INLINE FloatLanes Gather(const float* pBase, IntLanes indices) { return _mm256_i32gather_ps(pBase, indices, 4); }
+
+#elif defined(EXELIUS_SIMD_SSE2)
+		//----------------------------------------------------------------------------------------------------
+		// SSE2 - 4 Lanes
+		//----------------------------------------------------------------------------------------------------
+		static constexpr size_t kLaneCount = 4;
+		using FloatLanes = __m128;
+		using IntLanes = __m128i;
+
+		EXELIUS_SIMD_INLINE FloatLanes SetFloat(float value) { return _mm_set1_ps(value); }
+		EXELIUS_SIMD_INLINE FloatLanes LoadFloat(const float* pValues) { return _mm_loadu_ps(pValues); }
+		EXELIUS_SIMD_INLINE void StoreFloat(float* pValues, FloatLanes lanes) { _mm_storeu_ps(pValues, lanes); }
+		EXELIUS_SIMD_INLINE FloatLanes LaneIndices() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+
+		EXELIUS_SIMD_INLINE FloatLanes Add(FloatLanes a, FloatLanes b) { return _mm_add_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Sub(FloatLanes a, FloatLanes b) { return _mm_sub_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Mul(FloatLanes a, FloatLanes b) { return _mm_mul_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Div(FloatLanes a, FloatLanes b) { return _mm_div_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Min(FloatLanes a, FloatLanes b) { return _mm_min_ps(a, b); }
+		EXELIUS_SIMD_INLINE FloatLanes Max(FloatLanes a, FloatLanes b) { return _mm_max_ps(a, b); }
+
+		EXELIUS_SIMD_INLINE IntLanes SetInt(uint32_t value) { return _mm_set1_epi32(static_cast<int>(value)); }
+		EXELIUS_SIMD_INLINE IntLanes LoadInt(const int* pValues) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pValues)); }
+		EXELIUS_SIMD_INLINE void StoreInt(unsigned int* pValues, IntLanes lanes) { _mm_storeu_si128(reinterpret_cast<__m128i*>(pValues), lanes); }
+		EXELIUS_SIMD_INLINE IntLanes IntLaneIndices() { return _mm_setr_epi32(0, 1, 2, 3); }
+		EXELIUS_SIMD_INLINE IntLanes AddInt(IntLanes a, IntLanes b) { return _mm_add_epi32(a, b); }
+		EXELIUS_SIMD_INLINE IntLanes SubInt(IntLanes a, IntLanes b) { return _mm_sub_epi32(a, b); }
+		EXELIUS_SIMD_INLINE IntLanes Xor(IntLanes a, IntLanes b) { return _mm_xor_si128(a, b); }
+		EXELIUS_SIMD_INLINE IntLanes And(IntLanes a, IntLanes b) { return _mm_and_si128(a, b); }
+		template <int kBits> EXELIUS_SIMD_INLINE IntLanes ShiftRight(IntLanes a) { return _mm_srli_epi32(a, kBits); }
+		template <int kBits> EXELIUS_SIMD_INLINE IntLanes ShiftLeft(IntLanes a) { return _mm_slli_epi32(a, kBits); }
+
+		EXELIUS_SIMD_INLINE IntLanes MulInt(IntLanes a, IntLanes b)
+		{
+			// SSE2 has no 32 bit low multiply (that arrived with SSE4.1), so multiply the even
+			// and odd lanes separately as 64 bit products and stitch the low halves back together.
+			const __m128i evenProducts = _mm_mul_epu32(a, b);
+			const __m128i oddProducts = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+			return _mm_unpacklo_epi32(_mm_shuffle_epi32(evenProducts, _MM_SHUFFLE(0, 0, 2, 0)),
+				_mm_shuffle_epi32(oddProducts, _MM_SHUFFLE(0, 0, 2, 0)));
+		}
+
+		EXELIUS_SIMD_INLINE IntLanes TruncateToInt(FloatLanes a) { return _mm_cvttps_epi32(a); }
+		EXELIUS_SIMD_INLINE FloatLanes IntToFloat(IntLanes a) { return _mm_cvtepi32_ps(a); }
+		EXELIUS_SIMD_INLINE IntLanes AsInt(FloatLanes a) { return _mm_castps_si128(a); }
+
+		EXELIUS_SIMD_INLINE FloatLanes Gather(const float* pBase, IntLanes indices)
+		{
+			// No gather instruction before AVX2, load each lane on its own.
+			alignas(16) int32_t laneIndices[kLaneCount];
+			_mm_store_si128(reinterpret_cast<__m128i*>(laneIndices), indices);
+			return _mm_setr_ps(pBase[laneIndices[0]], pBase[laneIndices[1]], pBase[laneIndices[2]], pBase[laneIndices[3]]);
+		}
+
+#else
+		//----------------------------------------------------------------------------------------------------
+		// Scalar - 1 Lane
+		//----------------------------------------------------------------------------------------------------
+		static constexpr size_t kLaneCount = 1;
+		using FloatLanes = float;
+		using IntLanes = uint32_t;
+
+		EXELIUS_SIMD_INLINE FloatLanes SetFloat(float value) { return value; }
+		EXELIUS_SIMD_INLINE FloatLanes LoadFloat(const float* pValues) { return *pValues; }
+		EXELIUS_SIMD_INLINE void StoreFloat(float* pValues, FloatLanes lanes) { *pValues = lanes; }
+		EXELIUS_SIMD_INLINE FloatLanes LaneIndices() { return 0.0f; }
+
+		EXELIUS_SIMD_INLINE FloatLanes Add(FloatLanes a, FloatLanes b) { return a + b; }
+		EXELIUS_SIMD_INLINE FloatLanes Sub(FloatLanes a, FloatLanes b) { return a - b; }
+		EXELIUS_SIMD_INLINE FloatLanes Mul(FloatLanes a, FloatLanes b) { return a * b; }
+		EXELIUS_SIMD_INLINE FloatLanes Div(FloatLanes a, FloatLanes b) { return a / b; }
+		EXELIUS_SIMD_INLINE FloatLanes Min(FloatLanes a, FloatLanes b) { return (a < b) ? a : b; }
+		EXELIUS_SIMD_INLINE FloatLanes Max(FloatLanes a, FloatLanes b) { return (a > b) ? a : b; }
+
+		EXELIUS_SIMD_INLINE IntLanes SetInt(uint32_t value) { return value; }
+		EXELIUS_SIMD_INLINE IntLanes LoadInt(const int* pValues) { return static_cast<uint32_t>(*pValues); }
+		EXELIUS_SIMD_INLINE void StoreInt(unsigned int* pValues, IntLanes lanes) { *pValues = lanes; }
+		EXELIUS_SIMD_INLINE IntLanes IntLaneIndices() { return 0; }
+		EXELIUS_SIMD_INLINE IntLanes AddInt(IntLanes a, IntLanes b) { return a + b; }
+		EXELIUS_SIMD_INLINE IntLanes SubInt(IntLanes a, IntLanes b) { return a - b; }
+		EXELIUS_SIMD_INLINE IntLanes MulInt(IntLanes a, IntLanes b) { return a * b; }
+		EXELIUS_SIMD_INLINE IntLanes Xor(IntLanes a, IntLanes b) { return a ^ b; }
+		EXELIUS_SIMD_INLINE IntLanes And(IntLanes a, IntLanes b) { return a & b; }
+		template <int kBits> EXELIUS_SIMD_INLINE IntLanes ShiftRight(IntLanes a) { return a >> kBits; }
+		template <int kBits> EXELIUS_SIMD_INLINE IntLanes ShiftLeft(IntLanes a) { return a << kBits; }
+
+		EXELIUS_SIMD_INLINE IntLanes TruncateToInt(FloatLanes a) { return static_cast<uint32_t>(static_cast<int>(a)); }
+		EXELIUS_SIMD_INLINE FloatLanes IntToFloat(IntLanes a) { return static_cast<float>(static_cast<int>(a)); }
+		EXELIUS_SIMD_INLINE IntLanes AsInt(FloatLanes a) { IntLanes bits; std::memcpy(&bits, &a, sizeof(bits)); return bits; }
+
+		EXELIUS_SIMD_INLINE FloatLanes Gather(const float* pBase, IntLanes indices) { return pBase[static_cast<int>(indices)]; }
+#endif
+
+		//----------------------------------------------------------------------------------------------------
+		// Shared Helpers
+		//----------------------------------------------------------------------------------------------------
+
+		/// <summary>
+		/// Converts unsigned 32 bit lanes to float. There is no unsigned conversion below AVX-512, so the
+		/// value is split into two exactly representable 16 bit halves and recombined with a single
+		/// rounding, which matches static_cast&lt;float&gt;(unsigned int) bit for bit.
+		/// </summary>
+		EXELIUS_SIMD_INLINE FloatLanes UIntToFloat(IntLanes a)
+		{
+			const FloatLanes high = IntToFloat(ShiftRight<16>(a));
+			const FloatLanes low = IntToFloat(And(a, SetInt(0xffff)));
+			return Add(Mul(high, SetFloat(65536.0f)), low);
+		}
+
+		/// <summary>
+		/// Lane version of Exelius::Lerp. Same operation order.
+		/// </summary>
+		EXELIUS_SIMD_INLINE FloatLanes LerpLanes(FloatLanes min, FloatLanes max, FloatLanes weight)
+		{
+			return Add(Mul(Sub(SetFloat(1.0f), weight), min), Mul(weight, max));
+		}
+
+		/// <summary>
+		/// Lane version of Exelius::SmootherStep. Same operation order, including the clamp to [0, 1].
+		/// </summary>
+		EXELIUS_SIMD_INLINE FloatLanes SmootherStepLanes(FloatLanes x)
+		{
+			const FloatLanes cubed = Mul(Mul(x, x), x);
+			const FloatLanes polynomial = Add(Mul(x, Sub(Mul(x, SetFloat(6.0f)), SetFloat(15.0f))), SetFloat(10.0f));
+			return Min(Max(Mul(cubed, polynomial), SetFloat(0.0f)), SetFloat(1.0f));
+		}
+	}
+}
\ No newline at end of file
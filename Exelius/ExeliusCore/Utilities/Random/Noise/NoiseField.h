@@ -0,0 +1,231 @@
+#pragma once
+#include "Utilities/Random/Noise/OctaveRow.h"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace Exelius
+{
+	/// <summary>
+	/// A grid of fBm values that keeps every octave's raw noise plane around.
+	///
+	/// NoiseBackend is the noise type (PerlinNoise or SimplexNoise). Any type with the same static octave
+	/// functions works: a RowCache type, GetOctaveNoiseRow, GetOctaveNoiseRows and BlendOctaves.
+	///
+	/// The octaves of NoiseBackend::GetAverageNoise only depend on the seed, the input range and the grid
+	/// layout. Persistance and octave count only change how the octaves are blended. Once the planes are
+	/// cached, changing those two is a weighted sum over the planes (BlendSpan) rather than a full noise
+	/// evaluation, and adding octaves only generates the new ones.
+	///
+	/// Memory cost is one float per tile per cached octave.
+	///
+	/// \b Usage:
+	/// ~~~~~
+	/// field.BeginUpdate(...);               // One thread.
+	/// field.GenerateSpan(cache, start, n);  // Any number of threads, disjoint spans.
+	/// field.EndUpdate();                    // One thread, after the spans are done.
+	/// field.BlendSpan(start, n, octaves, persistance, pOut);
+	/// ~~~~~
+	/// </summary>
+	template <class NoiseBackend>
+	class NoiseField
+	{
+		// NoiseParameters caps octaves at 6, this leaves some headroom.
+		static constexpr unsigned int kMaxBlendOctaves = 16;
+
+		// Octave rows GenerateSpans hands to the backend in one call.
+		static constexpr size_t kMaxFusedRows = 32;
+
+		std::vector<std::vector<float>> m_octavePlanes;
+
+		unsigned int m_width;
+		unsigned int m_height;
+		unsigned int m_originColumn;
+		unsigned int m_originRow;
+		float m_tileWidth;
+		float m_tileHeight;
+		float m_maxX;
+		float m_maxY;
+		unsigned int m_inputRange;
+		unsigned int m_seed;
+
+		// Octaves [0, m_cachedOctaves) hold valid noise.
+		// Octaves [m_cachedOctaves, m_requestedOctaves) are filled in by GenerateSpan during an update.
+		unsigned int m_cachedOctaves;
+		unsigned int m_requestedOctaves;
+
+	public:
+		NoiseField()
+			: m_width(0)
+			, m_height(0)
+			, m_originColumn(0)
+			, m_originRow(0)
+			, m_tileWidth(0.0f)
+			, m_tileHeight(0.0f)
+			, m_maxX(0.0f)
+			, m_maxY(0.0f)
+			, m_inputRange(0)
+			, m_seed(0)
+			, m_cachedOctaves(0)
+			, m_requestedOctaves(0)
+		{
+			//
+		}
+
+		/// <summary>
+		/// Start an update for the given layout and noise settings. If anything other than the octave count
+		/// differs from the cached planes, the cache is dropped and every octave is generated again.
+		/// </summary>
+		/// <param name="width">Number of tiles in a row.</param>
+		/// <param name="height">Number of rows.</param>
+		/// <param name="tileWidth">Distance between tiles in x, in the same units as maxX.</param>
+		/// <param name="tileHeight">Distance between rows in y, in the same units as maxY.</param>
+		/// <param name="maxX">maxX as passed to NoiseBackend::GetAverageNoise.</param>
+		/// <param name="maxY">maxY as passed to NoiseBackend::GetAverageNoise.</param>
+		/// <param name="inputRange">Base input range as passed to NoiseBackend::GetAverageNoise.</param>
+		/// <param name="numOctaves">Number of octaves that should be available after the update.</param>
+		/// <param name="seed">Base seed as passed to NoiseBackend::GetAverageNoise.</param>
+		/// <param name="originColumn">Column of the first tile, when the grid is a window of a larger map.</param>
+		/// <param name="originRow">Row of the first tile, when the grid is a window of a larger map.</param>
+		void BeginUpdate(unsigned int width, unsigned int height, float tileWidth, float tileHeight,
+			float maxX, float maxY, unsigned int inputRange, unsigned int numOctaves, unsigned int seed,
+			unsigned int originColumn = 0, unsigned int originRow = 0)
+		{
+			if (numOctaves > kMaxBlendOctaves)
+				numOctaves = kMaxBlendOctaves;
+
+			if (width != m_width || height != m_height || originColumn != m_originColumn || originRow != m_originRow
+				|| tileWidth != m_tileWidth || tileHeight != m_tileHeight
+				|| maxX != m_maxX || maxY != m_maxY || inputRange != m_inputRange || seed != m_seed)
+			{
+				m_cachedOctaves = 0;
+
+				m_width = width;
+				m_height = height;
+				m_originColumn = originColumn;
+				m_originRow = originRow;
+				m_tileWidth = tileWidth;
+				m_tileHeight = tileHeight;
+				m_maxX = maxX;
+				m_maxY = maxY;
+				m_inputRange = inputRange;
+				m_seed = seed;
+			}
+
+			// Only ever grow, fewer octaves is just a different blend.
+			m_requestedOctaves = (numOctaves > m_cachedOctaves) ? numOctaves : m_cachedOctaves;
+
+			const size_t planeSize = (size_t)m_width * (size_t)m_height;
+			if (m_octavePlanes.size() < m_requestedOctaves)
+				m_octavePlanes.resize(m_requestedOctaves);
+
+			for (unsigned int octave = m_cachedOctaves; octave < m_requestedOctaves; ++octave)
+			{
+				m_octavePlanes[octave].resize(planeSize);
+			}
+		}
+
+		/// <summary>
+		/// True if the current update has octaves to generate, false if it is a pure re-blend.
+		/// </summary>
+		bool NeedsGeneration() const { return m_cachedOctaves < m_requestedOctaves; }
+
+		/// <summary>
+		/// Generate the missing octaves for a span of tiles. The span must not cross a row boundary.
+		/// Safe to call from several threads at once as long as the spans do not overlap.
+		/// </summary>
+		void GenerateSpan(typename NoiseBackend::RowCache& cache, size_t startIndex, size_t count)
+		{
+			if (count == 0 || !NeedsGeneration())
+				return;
+
+			// Same tile positions as TileMap::GetTilePosition.
+			const float startX = (float)(m_originColumn + startIndex % m_width) * m_tileWidth;
+			const float y = (float)(m_originRow + startIndex / m_width) * m_tileHeight;
+
+			for (unsigned int octave = m_cachedOctaves; octave < m_requestedOctaves; ++octave)
+			{
+				NoiseBackend::GetOctaveNoiseRow(cache, octave, startX, m_tileWidth, y, m_octavePlanes[octave].data() + startIndex, count,
+					m_maxX, m_maxY, m_inputRange, m_seed);
+			}
+		}
+
+		/// <summary>
+		/// GenerateSpan for several fields at once. The missing octaves of every field are generated in one fused
+		/// NoiseBackend::GetOctaveNoiseRows pass, so the pixel loop is shared between the channels. The fields
+		/// must have the same width, origin and tile size (maxX, maxY, input range and seed can differ).
+		/// </summary>
+		static void GenerateSpans(typename NoiseBackend::RowCache& cache, NoiseField* const* ppFields, size_t numFields, size_t startIndex, size_t count)
+		{
+			if (count == 0 || numFields == 0)
+				return;
+
+			const NoiseField& layout = *ppFields[0];
+			const float startX = (float)(layout.m_originColumn + startIndex % layout.m_width) * layout.m_tileWidth;
+			const float y = (float)(layout.m_originRow + startIndex / layout.m_width) * layout.m_tileHeight;
+
+			std::array<OctaveRow, kMaxFusedRows> rows;
+			size_t numRows = 0;
+
+			for (size_t field = 0; field < numFields; ++field)
+			{
+				NoiseField& noiseField = *ppFields[field];
+				for (unsigned int octave = noiseField.m_cachedOctaves; octave < noiseField.m_requestedOctaves; ++octave)
+				{
+					if (numRows == rows.size())
+					{
+						NoiseBackend::GetOctaveNoiseRows(cache, rows.data(), numRows, startX, layout.m_tileWidth, y, count);
+						numRows = 0;
+					}
+
+					rows[numRows++] = OctaveRow{ octave, noiseField.m_maxX, noiseField.m_maxY, noiseField.m_inputRange, noiseField.m_seed,
+						noiseField.m_octavePlanes[octave].data() + startIndex };
+				}
+			}
+
+			NoiseBackend::GetOctaveNoiseRows(cache, rows.data(), numRows, startX, layout.m_tileWidth, y, count);
+		}
+
+		/// <summary>
+		/// Finish the update, the generated octaves become part of the cache.
+		/// </summary>
+		void EndUpdate()
+		{
+			m_cachedOctaves = m_requestedOctaves;
+		}
+
+		/// <summary>
+		/// Blend the cached octaves into pOutNoise. The result is what NoiseBackend::GetAverageNoise would return
+		/// for the same tiles with numOctaves and persistance. During an update the span's missing octaves must
+		/// be generated first (GenerateSpan), numOctaves is capped at the octaves the update asked for.
+		/// </summary>
+		void BlendSpan(size_t startIndex, size_t count, unsigned int numOctaves, float persistance, float* pOutNoise) const
+		{
+			if (numOctaves > m_requestedOctaves)
+				numOctaves = m_requestedOctaves;
+
+			std::array<const float*, kMaxBlendOctaves> octaveRows{};
+			for (unsigned int octave = 0; octave < numOctaves; ++octave)
+			{
+				octaveRows[octave] = m_octavePlanes[octave].data() + startIndex;
+			}
+
+			NoiseBackend::BlendOctaves(octaveRows.data(), numOctaves, persistance, pOutNoise, count);
+		}
+
+		/// <summary>
+		/// Drop every cached octave.
+		/// </summary>
+		void Clear()
+		{
+			m_octavePlanes.clear();
+			m_cachedOctaves = 0;
+			m_requestedOctaves = 0;
+			m_width = 0;
+			m_height = 0;
+		}
+
+		unsigned int GetCachedOctaves() const { return m_cachedOctaves; }
+	};
+}
\ No newline at end of file
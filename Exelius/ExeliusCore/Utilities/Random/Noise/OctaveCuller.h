@@ -0,0 +1,263 @@
+#pragma once
+#include "Utilities/Math/Simd.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Exelius
+{
+	/// <summary>
+	/// Opt-in version of NoiseBackend::GetAverageNoiseRow for callers that only need to know which band a
+	/// value falls in for most pixels (ocean, mountain...) and the exact value for the rest.
+	///
+	/// Octaves are summed coarse to fine and checked kBlockSize pixels at a time. After each octave, the
+	/// octaves that are left can move a sum by at most their amplitude times NoiseBackend::kOctaveNoiseBound.
+	/// If the lowest and highest value any pixel in the block could still end up with land in the same band
+	/// (and that band does not need the exact value), the block is done and its finer octaves are never
+	/// evaluated.
+	///
+	/// Blocks that run to the last octave get exactly the values GetAverageNoiseRow would return. Culled
+	/// blocks get their partial sums, which classify the same as the full values would have.
+	///
+	/// Classification:
+	///		The caller's value for a pixel is noise * pScales[i] (pScales may be null, which means 1).
+	///		Scales must not be negative. classify(value) returns the band of a value (>= 0), or a negative
+	///		number when the value needs every octave. Every band has to be one contiguous range of values.
+	///
+	/// Keep one per thread next to the backend's RowCache, the scratch rows are reused between calls.
+	/// </summary>
+	template <class NoiseBackend>
+	class OctaveCuller
+	{
+		static constexpr size_t kBlockSize = 32;
+
+		// Covers the float rounding in the octave sums, relative to the total amplitude.
+		static constexpr float kCullMargin = 1e-4f;
+
+		std::vector<float> m_sums;
+		std::vector<float> m_octaveNoise;
+		std::vector<float> m_remainingAmplitudes;
+		std::vector<uint8_t> m_activeBlocks;
+
+		// Smallest and largest scale in each block, they don't change between octaves.
+		std::vector<float> m_lowScales;
+		std::vector<float> m_highScales;
+
+		size_t m_requestedOctaves;
+		size_t m_evaluatedOctaves;
+
+	public:
+		OctaveCuller()
+			: m_requestedOctaves(0)
+			, m_evaluatedOctaves(0)
+		{
+			//
+		}
+
+		/// <summary>
+		/// Same arguments and pixel positions as NoiseBackend::GetAverageNoiseRow, plus the classification.
+		/// startX and stepX are expected to be tile positions (whole numbers), so the x of every pixel in a
+		/// block matches the x the full row would use.
+		/// </summary>
+		template <class Classifier>
+		void GetAverageNoiseRow(typename NoiseBackend::RowCache& cache, float startX, float stepX, float y, float* pOutNoise, size_t count,
+			float maxX, float maxY, unsigned int noiseInputRange, unsigned int numOctaves, float persistance, unsigned int seedOverride,
+			const float* pScales, const Classifier& classify)
+		{
+			if (count == 0)
+				return;
+
+			if (numOctaves <= 0)
+			{
+				std::fill(pOutNoise, pOutNoise + count, 0.0f);
+				return;
+			}
+
+			// Same amplitude schedule (and summation order) as GetAverageNoise.
+			m_remainingAmplitudes.resize(numOctaves);
+			float currentAmplitude = 1.0f;
+			float totalAmplitude = 0.0f;
+			for (unsigned int octave = 0; octave < numOctaves; ++octave)
+			{
+				totalAmplitude += currentAmplitude;
+				m_remainingAmplitudes[octave] = currentAmplitude;
+				currentAmplitude *= persistance;
+			}
+
+			// m_remainingAmplitudes[octave] becomes the amplitude of every octave after it.
+			float remaining = 0.0f;
+			for (unsigned int octave = numOctaves; octave-- > 0;)
+			{
+				const float amplitude = m_remainingAmplitudes[octave];
+				m_remainingAmplitudes[octave] = remaining;
+				remaining += amplitude;
+			}
+
+			const size_t numBlocks = (count + kBlockSize - 1) / kBlockSize;
+			m_sums.assign(count, 0.0f);
+			m_octaveNoise.resize(count);
+			m_activeBlocks.assign(numBlocks, 1);
+			m_lowScales.assign(numBlocks, 1.0f);
+			m_highScales.assign(numBlocks, 1.0f);
+
+			if (pScales)
+			{
+				for (size_t block = 0; block < numBlocks; ++block)
+				{
+					const size_t blockStart = block * kBlockSize;
+					GetRange(pScales + blockStart, std::min(kBlockSize, count - blockStart), m_lowScales[block], m_highScales[block]);
+				}
+			}
+
+			const float margin = totalAmplitude * kCullMargin;
+
+			currentAmplitude = 1.0f;
+			for (unsigned int octave = 0; octave < numOctaves; ++octave)
+			{
+				const bool isLastOctave = (octave + 1 == numOctaves);
+				const float spread = m_remainingAmplitudes[octave] * NoiseBackend::kOctaveNoiseBound + margin;
+
+				size_t runEnd = 0;
+				for (size_t block = 0; block < numBlocks; ++block)
+				{
+					if (!m_activeBlocks[block])
+						continue;
+
+					const size_t blockStart = block * kBlockSize;
+					const size_t blockCount = std::min(kBlockSize, count - blockStart);
+					float* pSums = m_sums.data() + blockStart;
+
+					// Neighbouring active blocks are generated with one call.
+					if (blockStart >= runEnd)
+					{
+						size_t runBlocks = 1;
+						while (block + runBlocks < numBlocks && m_activeBlocks[block + runBlocks])
+							++runBlocks;
+
+						runEnd = std::min(count, blockStart + runBlocks * kBlockSize);
+						NoiseBackend::GetOctaveNoiseRow(cache, octave, startX + static_cast<float>(blockStart) * stepX, stepX, y,
+							m_octaveNoise.data() + blockStart, runEnd - blockStart, maxX, maxY, noiseInputRange, seedOverride);
+						m_evaluatedOctaves += runEnd - blockStart;
+					}
+
+					AccumulateOctave(pSums, m_octaveNoise.data() + blockStart, blockCount, currentAmplitude);
+
+					if (isLastOctave || IsBlockDecided(pSums, blockCount, m_lowScales[block], m_highScales[block], spread, totalAmplitude, classify))
+					{
+						FinishSums(pSums, blockCount, totalAmplitude, pOutNoise + blockStart);
+						m_activeBlocks[block] = 0;
+					}
+				}
+
+				currentAmplitude *= persistance;
+			}
+
+			m_requestedOctaves += count * numOctaves;
+		}
+
+		/// <summary>
+		/// Fraction of the requested pixel octaves (pixels * octaves) that were actually generated since the
+		/// last ResetStats.
+		/// </summary>
+		float GetEvaluatedFraction() const
+		{
+			return (m_requestedOctaves > 0) ? static_cast<float>(m_evaluatedOctaves) / static_cast<float>(m_requestedOctaves) : 1.0f;
+		}
+
+		void ResetStats()
+		{
+			m_requestedOctaves = 0;
+			m_evaluatedOctaves = 0;
+		}
+
+	private:
+
+		/// <summary>
+		/// True if the octaves that are left can't move any pixel of the block out of one band that
+		/// doesn't need the exact value.
+		/// </summary>
+		template <class Classifier>
+		static bool IsBlockDecided(const float* pSums, size_t count, float lowScale, float highScale, float spread, float totalAmplitude, const Classifier& classify)
+		{
+			float lowSum;
+			float highSum;
+			GetRange(pSums, count, lowSum, highSum);
+
+			// FinishAverageNoise is monotonic and never negative, so the extremes of noise * scale come from
+			// the extremes of both. Check the high end first, blocks that need the exact value usually fail there.
+			const int highBand = classify(NoiseBackend::FinishAverageNoise(highSum + spread, totalAmplitude) * highScale);
+			if (highBand < 0)
+				return false;
+
+			return (highBand == classify(NoiseBackend::FinishAverageNoise(lowSum - spread, totalAmplitude) * lowScale));
+		}
+
+		static void GetRange(const float* pValues, size_t count, float& low, float& high) noexcept
+		{
+			Simd::FloatLanes lowLanes = Simd::SetFloat(pValues[0]);
+			Simd::FloatLanes highLanes = lowLanes;
+
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				const Simd::FloatLanes values = Simd::LoadFloat(pValues + i);
+				lowLanes = Simd::Min(lowLanes, values);
+				highLanes = Simd::Max(highLanes, values);
+			}
+
+			float lanes[Simd::kLaneCount * 2];
+			Simd::StoreFloat(lanes, lowLanes);
+			Simd::StoreFloat(lanes + Simd::kLaneCount, highLanes);
+
+			low = lanes[0];
+			high = lanes[Simd::kLaneCount];
+			for (size_t lane = 1; lane < Simd::kLaneCount; ++lane)
+			{
+				low = std::min(low, lanes[lane]);
+				high = std::max(high, lanes[Simd::kLaneCount + lane]);
+			}
+
+			for (; i < count; ++i)
+			{
+				low = std::min(low, pValues[i]);
+				high = std::max(high, pValues[i]);
+			}
+		}
+
+		/// <summary>
+		/// Adds an octave into the running sums.
+		/// </summary>
+		static void AccumulateOctave(float* pSums, const float* pOctaveNoise, size_t count, float amplitude) noexcept
+		{
+			const Simd::FloatLanes amplitudeLanes = Simd::SetFloat(amplitude);
+
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				// Same operations as BlendOctaves, so the sums match it bit for bit.
+				Simd::StoreFloat(pSums + i, Simd::Add(Simd::LoadFloat(pSums + i), Simd::Mul(Simd::LoadFloat(pOctaveNoise + i), amplitudeLanes)));
+			}
+
+			for (; i < count; ++i)
+			{
+				pSums[i] += pOctaveNoise[i] * amplitude;
+			}
+		}
+
+		static void FinishSums(const float* pSums, size_t count, float totalAmplitude, float* pOutNoise) noexcept
+		{
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				Simd::StoreFloat(pOutNoise + i, NoiseBackend::FinishAverageNoiseLanes(Simd::LoadFloat(pSums + i), totalAmplitude));
+			}
+
+			for (; i < count; ++i)
+			{
+				pOutNoise[i] = NoiseBackend::FinishAverageNoise(pSums[i], totalAmplitude);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace Exelius
+{
+	/// <summary>
+	/// One output row of a fused octave evaluation (NoiseBackend::GetOctaveNoiseRows). Each row is a single
+	/// octave of its own fBm channel, so rows in the same call can use different seeds, input ranges and
+	/// scales. The arguments match GetOctaveNoiseRow.
+	/// </summary>
+	struct OctaveRow
+	{
+		unsigned int m_octave;
+		float m_maxX;
+		float m_maxY;
+		unsigned int m_noiseInputRange;
+		unsigned int m_seed;
+		float* m_pOutNoise;
+	};
+}
\ No newline at end of file
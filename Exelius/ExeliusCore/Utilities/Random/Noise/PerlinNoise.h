@@ -1,7 +1,13 @@
 #pragma once
 #include "Utilities/Math/Math.h"
+#include "Utilities/Math/Simd.h"
+#include "Utilities/Random/Noise/OctaveRow.h"
 #include "Utilities/Random/Noise/SquirrelNoise.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 namespace Exelius
 {
 	/// <summary>
@@ -12,6 +18,8 @@ namespace Exelius
 	class PerlinNoise
 	{
 		static constexpr unsigned int kPrime = 198491317;
+		static constexpr unsigned int kOctaveSeedMultiplier = 7322071;
+		static constexpr size_t kMaxFusedRows = 16;
 		unsigned int m_seed;
 
 	public:
@@ -83,7 +91,6 @@ namespace Exelius
 
 		static constexpr float GetAverageNoise(float x, float y, float maxX, float maxY, unsigned int noiseinputRange, unsigned int numOctaves, float persistance, unsigned int seedOverride) noexcept
 		{
-			constexpr unsigned int kSeedMultiplier = 7322071;
 			if (numOctaves <= 0)
 				return 0.0f;
 
@@ -94,7 +101,7 @@ namespace Exelius
 			{
 				totalAmplitude += currentAmplitude;
 
-				seedOverride = seedOverride + (i * kSeedMultiplier);
+				seedOverride = seedOverride + (i * kOctaveSeedMultiplier);
 				float localNoise = GetNoise(x, y, maxX, maxY, noiseinputRange, seedOverride);
 				noise += localNoise * currentAmplitude;
 
@@ -102,6 +109,354 @@ namespace Exelius
 				noiseinputRange *= 2;
 			}
 
+			return FinishAverageNoise(noise, totalAmplitude);
+		}
+
+		constexpr float GetAverageNoise(float x, float y, float maxX, float maxY, unsigned int noiseinputRange, unsigned int numOctaves, float persistance) const noexcept
+		{
+			return GetAverageNoise(x, y, maxX, maxY, noiseinputRange, numOctaves, persistance, m_seed);
+		}
+
+		//----------------------------------------------------------------------------------------------------
+		// Batch Noise Functions
+		// These evaluate Simd::kLaneCount points per step (8 with AVX2, 4 with SSE2, 1 otherwise) and fall
+		// back to the scalar GetAverageNoise for any leftover points. The lanes follow the scalar operation
+		// order exactly, so the results are normally bit identical. The documented guarantee is an absolute
+		// difference of at most kBatchNoiseTolerance, which leaves room for compilers that contract the
+		// lerps into fused multiply-adds.
+		//----------------------------------------------------------------------------------------------------
+
+		static constexpr float kBatchNoiseTolerance = 1e-5f;
+
+		/// <summary>
+		/// Fills pOutNoise[i] with GetAverageNoise(pX[i], pY[i], ...) for every point in the span.
+		/// </summary>
+		static void GetAverageNoise(const float* pX, const float* pY, float* pOutNoise, size_t count, float maxX, float maxY, unsigned int noiseInputRange, unsigned int numOctaves, float persistance, unsigned int seedOverride) noexcept
+		{
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				const Simd::FloatLanes noise = GetAverageNoiseLanes(Simd::LoadFloat(pX + i), Simd::LoadFloat(pY + i),
+					maxX, maxY, noiseInputRange, numOctaves, persistance, seedOverride);
+				Simd::StoreFloat(pOutNoise + i, noise);
+			}
+
+			for (; i < count; ++i)
+			{
+				pOutNoise[i] = GetAverageNoise(pX[i], pY[i], maxX, maxY, noiseInputRange, numOctaves, persistance, seedOverride);
+			}
+		}
+
+		void GetAverageNoise(const float* pX, const float* pY, float* pOutNoise, size_t count, float maxX, float maxY, unsigned int noiseInputRange, unsigned int numOctaves, float persistance) const noexcept
+		{
+			GetAverageNoise(pX, pY, pOutNoise, count, maxX, maxY, noiseInputRange, numOctaves, persistance, m_seed);
+		}
+
+		/// <summary>
+		/// Lattice gradients for the cells touched by a row, one table per octave. Every pixel inside a cell
+		/// shares the same four corner gradients, so they are hashed once per cell instead of once per pixel.
+		/// Rows that stay inside the same lattice row (most of them, at low input ranges a cell spans hundreds
+		/// of pixels) reuse the tables as they are. Keep one per thread and pass it to every row.
+		/// </summary>
+		class RowCache
+		{
+			friend class PerlinNoise;
+
+			struct OctaveGradients
+			{
+				// Four planes of m_cellCount floats, one entry per cell:
+				// top unitX, top unitY, bottom unitX, bottom unitY.
+				std::vector<float> m_gradients;
+				size_t m_cellCount = 0;
+				int m_firstCellX = 0;
+				int m_lastCellX = 0;
+				int m_cellY = 0;
+				unsigned int m_seed = 0;
+
+				void Update(int firstCellX, int lastCellX, int cellY, unsigned int seed)
+				{
+					if (!m_gradients.empty() && seed == m_seed && cellY == m_cellY
+						&& firstCellX >= m_firstCellX && lastCellX <= m_lastCellX)
+					{
+						return;
+					}
+
+					m_firstCellX = firstCellX;
+					m_lastCellX = lastCellX;
+					m_cellY = cellY;
+					m_seed = seed;
+
+					m_cellCount = (size_t)lastCellX - (size_t)firstCellX + 1;
+					m_gradients.resize(m_cellCount * 4);
+
+					// Same hashes (and argument order) as DotGridGradient, with the cells along the row as the
+					// consecutive coordinate.
+					float* pGradients = m_gradients.data();
+					SquirrelNoise::GetUniform3DNoiseSequenceY(cellY, firstCellX, 0, pGradients, m_cellCount, seed);
+					SquirrelNoise::GetUniform3DNoiseSequenceY(cellY, firstCellX, 100, pGradients + m_cellCount, m_cellCount, seed);
+					SquirrelNoise::GetUniform3DNoiseSequenceY(cellY + 1, firstCellX, 0, pGradients + m_cellCount * 2, m_cellCount, seed);
+					SquirrelNoise::GetUniform3DNoiseSequenceY(cellY + 1, firstCellX, 100, pGradients + m_cellCount * 3, m_cellCount, seed);
+				}
+			};
+
+			std::vector<OctaveGradients> m_octaves;
+		};
+
+		/// <summary>
+		/// Fills a row of points: pOutNoise[i] = GetAverageNoise(startX + i * stepX, y, ...).
+		/// The corner gradients come from the cache (see RowCache) rather than being hashed per pixel.
+		/// </summary>
+		static void GetAverageNoiseRow(RowCache& cache, float startX, float stepX, float y, float* pOutNoise, size_t count, float maxX, float maxY, unsigned int noiseInputRange, unsigned int numOctaves, float persistance, unsigned int seedOverride) noexcept
+		{
+			if (count == 0)
+				return;
+
+			if (numOctaves <= 0)
+			{
+				std::fill(pOutNoise, pOutNoise + count, 0.0f);
+				return;
+			}
+
+			const float unitY = y / maxY;
+
+			// Make sure every octave has the gradients for the cells this row spans.
+			if (cache.m_octaves.size() < numOctaves)
+				cache.m_octaves.resize(numOctaves);
+
+			const float firstX = startX;
+			const float lastX = startX + static_cast<float>(count - 1) * stepX;
+			unsigned int octaveSeed = seedOverride;
+			unsigned int octaveInputRange = noiseInputRange;
+			for (unsigned int i = 0; i < numOctaves; ++i)
+			{
+				octaveSeed = octaveSeed + (i * kOctaveSeedMultiplier);
+
+				const float inputRange = static_cast<float>(octaveInputRange);
+				const int firstCellX = (int)((firstX / maxX) * inputRange);
+				const int lastCellX = (int)((lastX / maxX) * inputRange);
+				const int cellY = (int)(unitY * inputRange);
+
+				// +1 for the right hand corners of the last cell.
+				cache.m_octaves[i].Update(std::min(firstCellX, lastCellX), std::max(firstCellX, lastCellX) + 1, cellY, octaveSeed);
+
+				octaveInputRange *= 2;
+			}
+
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				const Simd::FloatLanes columns = Simd::Add(Simd::SetFloat(static_cast<float>(i)), Simd::LaneIndices());
+				const Simd::FloatLanes xLanes = Simd::Add(Simd::SetFloat(startX), Simd::Mul(columns, Simd::SetFloat(stepX)));
+
+				const Simd::FloatLanes noise = GetAverageNoiseRowLanes(cache, xLanes, unitY, maxX, noiseInputRange, numOctaves, persistance);
+				Simd::StoreFloat(pOutNoise + i, noise);
+			}
+
+			for (; i < count; ++i)
+			{
+				const float x = startX + static_cast<float>(i) * stepX;
+				pOutNoise[i] = GetAverageNoise(x, y, maxX, maxY, noiseInputRange, numOctaves, persistance, seedOverride);
+			}
+		}
+
+		void GetAverageNoiseRow(RowCache& cache, float startX, float stepX, float y, float* pOutNoise, size_t count, float maxX, float maxY, unsigned int noiseInputRange, unsigned int numOctaves, float persistance) const noexcept
+		{
+			GetAverageNoiseRow(cache, startX, stepX, y, pOutNoise, count, maxX, maxY, noiseInputRange, numOctaves, persistance, m_seed);
+		}
+
+		//----------------------------------------------------------------------------------------------------
+		// Octave Functions
+		// GetAverageNoise is a weighted sum of independent octaves. These expose the octaves on their own so
+		// callers can cache them (see NoiseField) and blend them again later with another persistance or
+		// octave count. GetOctaveNoiseRow followed by BlendOctaves gives the same result as GetAverageNoiseRow.
+		//----------------------------------------------------------------------------------------------------
+
+		/// <summary>
+		/// |GetNoise| never exceeds this. Each corner's dot product is at most |dx| + |dy| (gradient components
+		/// are in [-1, 1]), and the smoothed lerps of those distances peak at 0.5 per axis.
+		/// </summary>
+		static constexpr float kOctaveNoiseBound = 1.0f;
+
+		/// <summary>
+		/// The seed GetAverageNoise uses for the given octave.
+		/// </summary>
+		static constexpr unsigned int GetOctaveSeed(unsigned int seed, unsigned int octave) noexcept
+		{
+			for (unsigned int i = 0; i <= octave; ++i)
+				seed = seed + (i * kOctaveSeedMultiplier);
+			return seed;
+		}
+
+		/// <summary>
+		/// The input range GetAverageNoise uses for the given octave.
+		/// </summary>
+		static constexpr unsigned int GetOctaveInputRange(unsigned int noiseInputRange, unsigned int octave) noexcept
+		{
+			return noiseInputRange << octave;
+		}
+
+		/// <summary>
+		/// Fills a row with the raw (un-weighted) noise of a single octave of GetAverageNoise:
+		/// pOutNoise[i] = GetNoise(startX + i * stepX, y, maxX, maxY, octave input range, octave seed).
+		/// noiseInputRange and seedOverride are the base values, exactly as passed to GetAverageNoise.
+		/// The octave uses its own slot in the cache.
+		/// </summary>
+		static void GetOctaveNoiseRow(RowCache& cache, unsigned int octave, float startX, float stepX, float y, float* pOutNoise, size_t count, float maxX, float maxY, unsigned int noiseInputRange, unsigned int seedOverride) noexcept
+		{
+			if (count == 0)
+				return;
+
+			const unsigned int octaveInputRange = GetOctaveInputRange(noiseInputRange, octave);
+			const unsigned int octaveSeed = GetOctaveSeed(seedOverride, octave);
+			const float inputRange = static_cast<float>(octaveInputRange);
+			const float unitY = y / maxY;
+
+			if (cache.m_octaves.size() <= octave)
+				cache.m_octaves.resize((size_t)octave + 1);
+
+			const float lastX = startX + static_cast<float>(count - 1) * stepX;
+			const int firstCellX = (int)((startX / maxX) * inputRange);
+			const int lastCellX = (int)((lastX / maxX) * inputRange);
+			RowCache::OctaveGradients& gradients = cache.m_octaves[octave];
+			gradients.Update(std::min(firstCellX, lastCellX), std::max(firstCellX, lastCellX) + 1, (int)(unitY * inputRange), octaveSeed);
+
+			const Simd::FloatLanes maxXLanes = Simd::SetFloat(maxX);
+			const Simd::FloatLanes inputRangeLanes = Simd::SetFloat(inputRange);
+
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				const Simd::FloatLanes columns = Simd::Add(Simd::SetFloat(static_cast<float>(i)), Simd::LaneIndices());
+				const Simd::FloatLanes xLanes = Simd::Add(Simd::SetFloat(startX), Simd::Mul(columns, Simd::SetFloat(stepX)));
+
+				const Simd::FloatLanes gridX = Simd::Mul(Simd::Div(xLanes, maxXLanes), inputRangeLanes);
+				Simd::StoreFloat(pOutNoise + i, GetNoiseRowLanes(gradients, gridX, unitY * inputRange));
+			}
+
+			for (; i < count; ++i)
+			{
+				const float x = startX + static_cast<float>(i) * stepX;
+				pOutNoise[i] = GetNoise(x, y, maxX, maxY, octaveInputRange, octaveSeed);
+			}
+		}
+
+		/// <summary>
+		/// Fused GetOctaveNoiseRow: fills numRows octave rows over the same pixels in one pass. Each row gets
+		/// exactly what GetOctaveNoiseRow would write for it, but the pixel positions and the loop are shared.
+		/// Row n uses cache slot n rather than the slot of its octave, so a cache is best kept for one kind of call.
+		/// </summary>
+		static void GetOctaveNoiseRows(RowCache& cache, const OctaveRow* pRows, size_t numRows, float startX, float stepX, float y, size_t count) noexcept
+		{
+			if (count == 0)
+				return;
+
+			if (cache.m_octaves.size() < numRows)
+				cache.m_octaves.resize(numRows);
+
+			// Rows are set up and evaluated kMaxFusedRows at a time.
+			for (size_t firstRow = 0; firstRow < numRows; firstRow += kMaxFusedRows)
+			{
+				const size_t chunkRows = std::min(kMaxFusedRows, numRows - firstRow);
+				const OctaveRow* pChunk = pRows + firstRow;
+
+				float maxXs[kMaxFusedRows];
+				float inputRanges[kMaxFusedRows];
+				float gridYs[kMaxFusedRows];
+				unsigned int octaveInputRanges[kMaxFusedRows];
+				unsigned int octaveSeeds[kMaxFusedRows];
+
+				const float lastX = startX + static_cast<float>(count - 1) * stepX;
+				for (size_t row = 0; row < chunkRows; ++row)
+				{
+					const OctaveRow& octaveRow = pChunk[row];
+					octaveInputRanges[row] = GetOctaveInputRange(octaveRow.m_noiseInputRange, octaveRow.m_octave);
+					octaveSeeds[row] = GetOctaveSeed(octaveRow.m_seed, octaveRow.m_octave);
+					maxXs[row] = octaveRow.m_maxX;
+					inputRanges[row] = static_cast<float>(octaveInputRanges[row]);
+
+					const float unitY = y / octaveRow.m_maxY;
+					gridYs[row] = unitY * inputRanges[row];
+
+					const int firstCellX = (int)((startX / maxXs[row]) * inputRanges[row]);
+					const int lastCellX = (int)((lastX / maxXs[row]) * inputRanges[row]);
+					cache.m_octaves[firstRow + row].Update(std::min(firstCellX, lastCellX), std::max(firstCellX, lastCellX) + 1, (int)gridYs[row], octaveSeeds[row]);
+				}
+
+				size_t i = 0;
+				for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				{
+					const Simd::FloatLanes columns = Simd::Add(Simd::SetFloat(static_cast<float>(i)), Simd::LaneIndices());
+					const Simd::FloatLanes xLanes = Simd::Add(Simd::SetFloat(startX), Simd::Mul(columns, Simd::SetFloat(stepX)));
+
+					for (size_t row = 0; row < chunkRows; ++row)
+					{
+						const Simd::FloatLanes gridX = Simd::Mul(Simd::Div(xLanes, Simd::SetFloat(maxXs[row])), Simd::SetFloat(inputRanges[row]));
+						Simd::StoreFloat(pChunk[row].m_pOutNoise + i, GetNoiseRowLanes(cache.m_octaves[firstRow + row], gridX, gridYs[row]));
+					}
+				}
+
+				for (; i < count; ++i)
+				{
+					const float x = startX + static_cast<float>(i) * stepX;
+					for (size_t row = 0; row < chunkRows; ++row)
+					{
+						const OctaveRow& octaveRow = pChunk[row];
+						octaveRow.m_pOutNoise[i] = GetNoise(x, y, octaveRow.m_maxX, octaveRow.m_maxY, octaveInputRanges[row], octaveSeeds[row]);
+					}
+				}
+			}
+		}
+
+		/// <summary>
+		/// Blends numOctaves rows of raw octave noise (ppOctaveNoise[octave][i]) into pOutNoise exactly the way
+		/// GetAverageNoise does: amplitude weighted sum, normalized and smoothed.
+		/// </summary>
+		static void BlendOctaves(const float* const* ppOctaveNoise, unsigned int numOctaves, float persistance, float* pOutNoise, size_t count) noexcept
+		{
+			if (numOctaves <= 0)
+			{
+				std::fill(pOutNoise, pOutNoise + count, 0.0f);
+				return;
+			}
+
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				Simd::FloatLanes noise = Simd::SetFloat(0.0f);
+				float currentAmplitude = 1.0f;
+				float totalAmplitude = 0.0f;
+				for (unsigned int octave = 0; octave < numOctaves; ++octave)
+				{
+					totalAmplitude += currentAmplitude;
+					noise = Simd::Add(noise, Simd::Mul(Simd::LoadFloat(ppOctaveNoise[octave] + i), Simd::SetFloat(currentAmplitude)));
+					currentAmplitude *= persistance;
+				}
+
+				Simd::StoreFloat(pOutNoise + i, FinishAverageNoiseLanes(noise, totalAmplitude));
+			}
+
+			for (; i < count; ++i)
+			{
+				float noise = 0.0f;
+				float currentAmplitude = 1.0f;
+				float totalAmplitude = 0.0f;
+				for (unsigned int octave = 0; octave < numOctaves; ++octave)
+				{
+					totalAmplitude += currentAmplitude;
+					noise += ppOctaveNoise[octave][i] * currentAmplitude;
+					currentAmplitude *= persistance;
+				}
+
+				pOutNoise[i] = FinishAverageNoise(noise, totalAmplitude);
+			}
+		}
+
+		/// <summary>
+		/// Turns an amplitude weighted octave sum into the value GetAverageNoise returns. Monotonic in noise,
+		/// so it can also be applied to the ends of a range of possible sums (see OctaveCuller).
+		/// </summary>
+		static constexpr float FinishAverageNoise(float noise, float totalAmplitude) noexcept
+		{
 			noise /= totalAmplitude;
 
 			noise = Normalize(noise, -0.707f, 0.707f);
@@ -111,9 +466,16 @@ namespace Exelius
 			return noise;
 		}
 
-		constexpr float GetAverageNoise(float x, float y, float maxX, float maxY, unsigned int noiseinputRange, unsigned int numOctaves, float persistance) const noexcept
+		/// <summary>
+		/// FinishAverageNoise for a set of lanes.
+		/// </summary>
+		static Simd::FloatLanes FinishAverageNoiseLanes(Simd::FloatLanes noise, float totalAmplitude) noexcept
 		{
-			return GetAverageNoise(x, y, maxX, maxY, noiseinputRange, numOctaves, persistance, m_seed);
+			noise = Simd::Div(noise, Simd::SetFloat(totalAmplitude));
+
+			noise = Simd::Div(Simd::Sub(noise, Simd::SetFloat(-0.707f)), Simd::SetFloat(0.707f - -0.707f));
+
+			return Simd::SmootherStepLanes(noise);
 		}
 
 		//----------------------------------------------------------------------------------------------------
@@ -140,5 +502,130 @@ namespace Exelius
 			// Dot product between the two vectors.
 			return (distanceX * unitX + distanceY * unitY);
 		}
+
+		//----------------------------------------------------------------------------------------------------
+		// Lane Versions
+		// Mirror GetAverageNoise, GetNoise and DotGridGradient above, one point per lane.
+		//----------------------------------------------------------------------------------------------------
+
+		static Simd::FloatLanes GetAverageNoiseLanes(Simd::FloatLanes x, Simd::FloatLanes y, float maxX, float maxY, unsigned int noiseInputRange, unsigned int numOctaves, float persistance, unsigned int seedOverride) noexcept
+		{
+			if (numOctaves <= 0)
+				return Simd::SetFloat(0.0f);
+
+			// The x / maxX part of the grid position does not change between octaves.
+			const Simd::FloatLanes unitX = Simd::Div(x, Simd::SetFloat(maxX));
+			const Simd::FloatLanes unitY = Simd::Div(y, Simd::SetFloat(maxY));
+
+			Simd::FloatLanes noise = Simd::SetFloat(0.0f);
+			float currentAmplitude = 1.0f;
+			float totalAmplitude = 0.0f;
+			for (unsigned int i = 0; i < numOctaves; ++i)
+			{
+				totalAmplitude += currentAmplitude;
+
+				seedOverride = seedOverride + (i * kOctaveSeedMultiplier);
+				const Simd::FloatLanes inputRange = Simd::SetFloat(static_cast<float>(noiseInputRange));
+				const Simd::FloatLanes localNoise = GetNoiseLanes(Simd::Mul(unitX, inputRange), Simd::Mul(unitY, inputRange), seedOverride);
+				noise = Simd::Add(noise, Simd::Mul(localNoise, Simd::SetFloat(currentAmplitude)));
+
+				currentAmplitude *= persistance;
+				noiseInputRange *= 2;
+			}
+
+			return FinishAverageNoiseLanes(noise, totalAmplitude);
+		}
+
+		static Simd::FloatLanes GetAverageNoiseRowLanes(const RowCache& cache, Simd::FloatLanes x, float unitY, float maxX, unsigned int noiseInputRange, unsigned int numOctaves, float persistance) noexcept
+		{
+			const Simd::FloatLanes unitX = Simd::Div(x, Simd::SetFloat(maxX));
+
+			Simd::FloatLanes noise = Simd::SetFloat(0.0f);
+			float currentAmplitude = 1.0f;
+			float totalAmplitude = 0.0f;
+			for (unsigned int i = 0; i < numOctaves; ++i)
+			{
+				totalAmplitude += currentAmplitude;
+
+				const float inputRange = static_cast<float>(noiseInputRange);
+				const Simd::FloatLanes localNoise = GetNoiseRowLanes(cache.m_octaves[i], Simd::Mul(unitX, Simd::SetFloat(inputRange)), unitY * inputRange);
+				noise = Simd::Add(noise, Simd::Mul(localNoise, Simd::SetFloat(currentAmplitude)));
+
+				currentAmplitude *= persistance;
+				noiseInputRange *= 2;
+			}
+
+			return FinishAverageNoiseLanes(noise, totalAmplitude);
+		}
+
+		static Simd::FloatLanes GetNoiseRowLanes(const RowCache::OctaveGradients& octave, Simd::FloatLanes x, float y) noexcept
+		{
+			const Simd::IntLanes xFloor = Simd::TruncateToInt(x);
+			const Simd::IntLanes xCeiling = Simd::AddInt(xFloor, Simd::SetInt(1));
+			const int yFloor = (int)y;
+			const int yCeiling = yFloor + 1;
+
+			const Simd::FloatLanes distanceLeft = Simd::Sub(x, Simd::IntToFloat(xFloor));
+			const Simd::FloatLanes distanceRight = Simd::Sub(x, Simd::IntToFloat(xCeiling));
+			const Simd::FloatLanes distanceTop = Simd::SetFloat(y - (float)yFloor);
+			const Simd::FloatLanes distanceBottom = Simd::SetFloat(y - (float)yCeiling);
+
+			const Simd::FloatLanes smoothWeightX = Simd::SmootherStepLanes(distanceLeft);
+			const Simd::FloatLanes smoothWeightY = Simd::SetFloat(SmootherStep(y - (float)yFloor));
+
+			// Offsets into the gradient planes.
+			const float* pTopX = octave.m_gradients.data();
+			const float* pTopY = pTopX + octave.m_cellCount;
+			const float* pBottomX = pTopY + octave.m_cellCount;
+			const float* pBottomY = pBottomX + octave.m_cellCount;
+			const Simd::IntLanes leftOffsets = Simd::SubInt(xFloor, Simd::SetInt(octave.m_firstCellX));
+			const Simd::IntLanes rightOffsets = Simd::AddInt(leftOffsets, Simd::SetInt(1));
+
+			const Simd::FloatLanes topLeftNoise = Simd::Add(Simd::Mul(distanceLeft, Simd::Gather(pTopX, leftOffsets)),
+				Simd::Mul(distanceTop, Simd::Gather(pTopY, leftOffsets)));
+			const Simd::FloatLanes topRightNoise = Simd::Add(Simd::Mul(distanceRight, Simd::Gather(pTopX, rightOffsets)),
+				Simd::Mul(distanceTop, Simd::Gather(pTopY, rightOffsets)));
+			const Simd::FloatLanes resultX = Simd::LerpLanes(topLeftNoise, topRightNoise, smoothWeightX);
+
+			const Simd::FloatLanes bottomLeftNoise = Simd::Add(Simd::Mul(distanceLeft, Simd::Gather(pBottomX, leftOffsets)),
+				Simd::Mul(distanceBottom, Simd::Gather(pBottomY, leftOffsets)));
+			const Simd::FloatLanes bottomRightNoise = Simd::Add(Simd::Mul(distanceRight, Simd::Gather(pBottomX, rightOffsets)),
+				Simd::Mul(distanceBottom, Simd::Gather(pBottomY, rightOffsets)));
+			const Simd::FloatLanes resultY = Simd::LerpLanes(bottomLeftNoise, bottomRightNoise, smoothWeightX);
+
+			return Simd::LerpLanes(resultX, resultY, smoothWeightY);
+		}
+
+		static Simd::FloatLanes GetNoiseLanes(Simd::FloatLanes x, Simd::FloatLanes y, unsigned int seedOverride) noexcept
+		{
+			const Simd::IntLanes xFloor = Simd::TruncateToInt(x);
+			const Simd::IntLanes xCeiling = Simd::AddInt(xFloor, Simd::SetInt(1));
+			const Simd::IntLanes yFloor = Simd::TruncateToInt(y);
+			const Simd::IntLanes yCeiling = Simd::AddInt(yFloor, Simd::SetInt(1));
+
+			const Simd::FloatLanes smoothWeightX = Simd::SmootherStepLanes(Simd::Sub(x, Simd::IntToFloat(xFloor)));
+			const Simd::FloatLanes smoothWeightY = Simd::SmootherStepLanes(Simd::Sub(y, Simd::IntToFloat(yFloor)));
+
+			const Simd::FloatLanes topLeftNoise = DotGridGradientLanes(xFloor, yFloor, x, y, seedOverride);
+			const Simd::FloatLanes topRightNoise = DotGridGradientLanes(xCeiling, yFloor, x, y, seedOverride);
+			const Simd::FloatLanes resultX = Simd::LerpLanes(topLeftNoise, topRightNoise, smoothWeightX);
+
+			const Simd::FloatLanes bottomLeftNoise = DotGridGradientLanes(xFloor, yCeiling, x, y, seedOverride);
+			const Simd::FloatLanes bottomRightNoise = DotGridGradientLanes(xCeiling, yCeiling, x, y, seedOverride);
+			const Simd::FloatLanes resultY = Simd::LerpLanes(bottomLeftNoise, bottomRightNoise, smoothWeightX);
+
+			return Simd::LerpLanes(resultX, resultY, smoothWeightY);
+		}
+
+		static Simd::FloatLanes DotGridGradientLanes(Simd::IntLanes cellX, Simd::IntLanes cellY, Simd::FloatLanes gridX, Simd::FloatLanes gridY, unsigned int seed) noexcept
+		{
+			const Simd::FloatLanes distanceX = Simd::Sub(gridX, Simd::IntToFloat(cellX));
+			const Simd::FloatLanes distanceY = Simd::Sub(gridY, Simd::IntToFloat(cellY));
+
+			const Simd::FloatLanes unitX = SquirrelNoise::GetUniform3DNoiseLanes(cellY, cellX, Simd::SetInt(0), seed);
+			const Simd::FloatLanes unitY = SquirrelNoise::GetUniform3DNoiseLanes(cellY, cellX, Simd::SetInt(100), seed);
+
+			return Simd::Add(Simd::Mul(distanceX, unitX), Simd::Mul(distanceY, unitY));
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,464 @@
+#pragma once
+#include "Utilities/Math/Math.h"
+#include "Utilities/Math/Simd.h"
+#include "Utilities/Random/Noise/OctaveRow.h"
+#include "Utilities/Random/Noise/SquirrelNoise.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Exelius
+{
+	/// <summary>
+	/// 2D gradient noise on a simplex (triangle) lattice, in the spirit of Ken Perlin's 2001 simplex noise
+	/// and the OpenSimplex family: https://en.wikipedia.org/wiki/Simplex_noise
+	///
+	/// Each point sums radial falloff contributions from the 3 corners of the triangle it lands in, rather
+	/// than lerping the 4 corners of a square cell like PerlinNoise. The triangle lattice has no preferred
+	/// axis, so the noise shows fewer of the horizontal/vertical streaks Perlin noise is known for.
+	///
+	/// The interface matches PerlinNoise, so either one can be used as a generator's noise backend. Octaves
+	/// use the same seed and input range schedule. Like PerlinNoise, input coordinates are expected to be
+	/// non-negative.
+	/// </summary>
+	class SimplexNoise
+	{
+		static constexpr unsigned int kPrime = 198491317;
+		static constexpr unsigned int kOctaveSeedMultiplier = 7322071;
+		static constexpr size_t kMaxFusedRows = 16;
+
+		// Skew from (x, y) space to the lattice and back: (sqrt(3) - 1) / 2 and (3 - sqrt(3)) / 6.
+		static constexpr float kSkew = 0.36602540f;
+		static constexpr float kUnskew = 0.21132487f;
+
+		// A corner stops contributing once a point is this far (squared) away from it.
+		static constexpr float kRadiusSquared = 0.5f;
+
+		// Brings the raw sum of the three corners into [-1, 1].
+		static constexpr float kScale = 99.2f;
+
+		// Simplex noise spreads out over its range a lot more than PerlinNoise (which rarely leaves
+		// +/-0.3 of its +/-0.707 range). Averaged noise is normalized over this wider range, picked so the
+		// finished values have about the same spread as PerlinNoise::GetAverageNoise, so generator
+		// thresholds tuned for one backend work for the other.
+		static constexpr float kAverageNoiseRange = 1.9f;
+
+		// 16 evenly spaced unit gradients (x, y), rotated half a step so none lines up with an axis.
+		static constexpr float kGradients[32] =
+		{
+			 0.98078528f,  0.19509032f,   0.83146961f,  0.55557023f,   0.55557023f,  0.83146961f,   0.19509032f,  0.98078528f,
+			-0.19509032f,  0.98078528f,  -0.55557023f,  0.83146961f,  -0.83146961f,  0.55557023f,  -0.98078528f,  0.19509032f,
+			-0.98078528f, -0.19509032f,  -0.83146961f, -0.55557023f,  -0.55557023f, -0.83146961f,  -0.19509032f, -0.98078528f,
+			 0.19509032f, -0.98078528f,   0.55557023f, -0.83146961f,   0.83146961f, -0.55557023f,   0.98078528f, -0.19509032f,
+		};
+
+		unsigned int m_seed;
+
+	public:
+
+		constexpr SimplexNoise(unsigned int seed = kPrime) noexcept
+			: m_seed(seed)
+		{
+			//
+		}
+
+		//----------------------------------------------------------------------------------------------------
+		// Noise Functions
+		//----------------------------------------------------------------------------------------------------
+
+		/// <summary>
+		/// Raw simplex noise in [-1, 1].
+		/// </summary>
+		static constexpr float GetNoise(float x, float y, unsigned int seedOverride) noexcept
+		{
+			// Find the lattice cell (a rhombus made of two triangles) the point is in.
+			const float skew = (x + y) * kSkew;
+			const int cellX = (int)(x + skew);
+			const int cellY = (int)(y + skew);
+
+			// Distance from the cell origin, back in (x, y) space.
+			const float unskew = (float)(cellX + cellY) * kUnskew;
+			const float distanceX0 = x - ((float)cellX - unskew);
+			const float distanceY0 = y - ((float)cellY - unskew);
+
+			// Pick the lower or upper triangle of the rhombus. The middle corner is one step in x or in y.
+			const int middleOffsetX = (distanceX0 > distanceY0) ? 1 : 0;
+			const int middleOffsetY = 1 - middleOffsetX;
+
+			const float distanceX1 = distanceX0 - (float)middleOffsetX + kUnskew;
+			const float distanceY1 = distanceY0 - (float)middleOffsetY + kUnskew;
+			const float distanceX2 = distanceX0 - 1.0f + (2.0f * kUnskew);
+			const float distanceY2 = distanceY0 - 1.0f + (2.0f * kUnskew);
+
+			float noise = CornerContribution(cellX, cellY, distanceX0, distanceY0, seedOverride);
+			noise += CornerContribution(cellX + middleOffsetX, cellY + middleOffsetY, distanceX1, distanceY1, seedOverride);
+			noise += CornerContribution(cellX + 1, cellY + 1, distanceX2, distanceY2, seedOverride);
+			return noise * kScale;
+		}
+
+		constexpr float GetNoise(float x, float y) const noexcept
+		{
+			return GetNoise(x, y, m_seed);
+		}
+
+		static constexpr float GetNoise(float x, float y, float maxX, float maxY, unsigned int noiseInputRange, unsigned int seedOverride) noexcept
+		{
+			float noiseGridX = (x / maxX) * static_cast<float>(noiseInputRange);
+			float noiseGridY = (y / maxY) * static_cast<float>(noiseInputRange);
+			return GetNoise(noiseGridX, noiseGridY, seedOverride);
+		}
+
+		constexpr float GetNoise(float x, float y, float maxX, float maxY, unsigned int noiseInputRange) const noexcept
+		{
+			return GetNoise(x, y, maxX, maxY, noiseInputRange, m_seed);
+		}
+
+		static constexpr float GetNormalizedNoise(float x, float y, unsigned int seedOverride) noexcept
+		{
+			return Normalize(GetNoise(x, y, seedOverride), -1.0f, 1.0f);
+		}
+
+		constexpr float GetNormalizedNoise(float x, float y) const noexcept
+		{
+			return GetNormalizedNoise(x, y, m_seed);
+		}
+
+		static constexpr float GetAverageNoise(float x, float y, float maxX, float maxY, unsigned int noiseinputRange, unsigned int numOctaves, float persistance, unsigned int seedOverride) noexcept
+		{
+			if (numOctaves <= 0)
+				return 0.0f;
+
+			float noise = 0.0f;
+			float currentAmplitude = 1.0f;
+			float totalAmplitude = 0.0f;
+			for (unsigned int i = 0; i < numOctaves; ++i)
+			{
+				totalAmplitude += currentAmplitude;
+
+				seedOverride = seedOverride + (i * kOctaveSeedMultiplier);
+				float localNoise = GetNoise(x, y, maxX, maxY, noiseinputRange, seedOverride);
+				noise += localNoise * currentAmplitude;
+
+				currentAmplitude *= persistance;
+				noiseinputRange *= 2;
+			}
+
+			return FinishAverageNoise(noise, totalAmplitude);
+		}
+
+		constexpr float GetAverageNoise(float x, float y, float maxX, float maxY, unsigned int noiseinputRange, unsigned int numOctaves, float persistance) const noexcept
+		{
+			return GetAverageNoise(x, y, maxX, maxY, noiseinputRange, numOctaves, persistance, m_seed);
+		}
+
+		//----------------------------------------------------------------------------------------------------
+		// Batch Noise Functions
+		// Same contract as the PerlinNoise row functions: Simd::kLaneCount points per step, scalar for the
+		// leftovers, same operation order as the scalar functions.
+		//----------------------------------------------------------------------------------------------------
+
+		/// <summary>
+		/// Simplex noise only hashes the 3 corners it touches, and the corners shift in both x and y along
+		/// a row, so there is nothing worth keeping between rows. Exists so callers can treat the backends
+		/// the same way.
+		/// </summary>
+		class RowCache
+		{
+		};
+
+		/// <summary>
+		/// Fills a row of points: pOutNoise[i] = GetAverageNoise(startX + i * stepX, y, ...).
+		/// </summary>
+		static void GetAverageNoiseRow([[maybe_unused]] RowCache& cache, float startX, float stepX, float y, float* pOutNoise, size_t count, float maxX, float maxY, unsigned int noiseInputRange, unsigned int numOctaves, float persistance, unsigned int seedOverride) noexcept
+		{
+			if (count == 0)
+				return;
+
+			if (numOctaves <= 0)
+			{
+				std::fill(pOutNoise, pOutNoise + count, 0.0f);
+				return;
+			}
+
+			const float unitY = y / maxY;
+
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				const Simd::FloatLanes columns = Simd::Add(Simd::SetFloat(static_cast<float>(i)), Simd::LaneIndices());
+				const Simd::FloatLanes xLanes = Simd::Add(Simd::SetFloat(startX), Simd::Mul(columns, Simd::SetFloat(stepX)));
+				const Simd::FloatLanes unitX = Simd::Div(xLanes, Simd::SetFloat(maxX));
+
+				Simd::FloatLanes noise = Simd::SetFloat(0.0f);
+				float currentAmplitude = 1.0f;
+				float totalAmplitude = 0.0f;
+				unsigned int octaveSeed = seedOverride;
+				unsigned int octaveInputRange = noiseInputRange;
+				for (unsigned int octave = 0; octave < numOctaves; ++octave)
+				{
+					totalAmplitude += currentAmplitude;
+
+					octaveSeed = octaveSeed + (octave * kOctaveSeedMultiplier);
+					const float inputRange = static_cast<float>(octaveInputRange);
+					const Simd::FloatLanes localNoise = GetNoiseLanes(Simd::Mul(unitX, Simd::SetFloat(inputRange)), Simd::SetFloat(unitY * inputRange), octaveSeed);
+					noise = Simd::Add(noise, Simd::Mul(localNoise, Simd::SetFloat(currentAmplitude)));
+
+					currentAmplitude *= persistance;
+					octaveInputRange *= 2;
+				}
+
+				Simd::StoreFloat(pOutNoise + i, FinishAverageNoiseLanes(noise, totalAmplitude));
+			}
+
+			for (; i < count; ++i)
+			{
+				const float x = startX + static_cast<float>(i) * stepX;
+				pOutNoise[i] = GetAverageNoise(x, y, maxX, maxY, noiseInputRange, numOctaves, persistance, seedOverride);
+			}
+		}
+
+		void GetAverageNoiseRow(RowCache& cache, float startX, float stepX, float y, float* pOutNoise, size_t count, float maxX, float maxY, unsigned int noiseInputRange, unsigned int numOctaves, float persistance) const noexcept
+		{
+			GetAverageNoiseRow(cache, startX, stepX, y, pOutNoise, count, maxX, maxY, noiseInputRange, numOctaves, persistance, m_seed);
+		}
+
+		//----------------------------------------------------------------------------------------------------
+		// Octave Functions
+		// See PerlinNoise. GetOctaveNoiseRow followed by BlendOctaves gives the same result as
+		// GetAverageNoiseRow.
+		//----------------------------------------------------------------------------------------------------
+
+		// |GetNoise| never exceeds this. kScale is picked so the three falloff weighted corner distances (an
+		// upper bound on the dot products with unit gradients) sum to at most 1.
+		static constexpr float kOctaveNoiseBound = 1.0f;
+
+		static constexpr unsigned int GetOctaveSeed(unsigned int seed, unsigned int octave) noexcept
+		{
+			for (unsigned int i = 0; i <= octave; ++i)
+				seed = seed + (i * kOctaveSeedMultiplier);
+			return seed;
+		}
+
+		static constexpr unsigned int GetOctaveInputRange(unsigned int noiseInputRange, unsigned int octave) noexcept
+		{
+			return noiseInputRange << octave;
+		}
+
+		/// <summary>
+		/// Fills a row with the raw (un-weighted) noise of a single octave of GetAverageNoise.
+		/// noiseInputRange and seedOverride are the base values, exactly as passed to GetAverageNoise.
+		/// </summary>
+		static void GetOctaveNoiseRow([[maybe_unused]] RowCache& cache, unsigned int octave, float startX, float stepX, float y, float* pOutNoise, size_t count, float maxX, float maxY, unsigned int noiseInputRange, unsigned int seedOverride) noexcept
+		{
+			const unsigned int octaveInputRange = GetOctaveInputRange(noiseInputRange, octave);
+			const unsigned int octaveSeed = GetOctaveSeed(seedOverride, octave);
+			const float inputRange = static_cast<float>(octaveInputRange);
+			const Simd::FloatLanes gridY = Simd::SetFloat((y / maxY) * inputRange);
+
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				const Simd::FloatLanes columns = Simd::Add(Simd::SetFloat(static_cast<float>(i)), Simd::LaneIndices());
+				const Simd::FloatLanes xLanes = Simd::Add(Simd::SetFloat(startX), Simd::Mul(columns, Simd::SetFloat(stepX)));
+
+				const Simd::FloatLanes gridX = Simd::Mul(Simd::Div(xLanes, Simd::SetFloat(maxX)), Simd::SetFloat(inputRange));
+				Simd::StoreFloat(pOutNoise + i, GetNoiseLanes(gridX, gridY, octaveSeed));
+			}
+
+			for (; i < count; ++i)
+			{
+				const float x = startX + static_cast<float>(i) * stepX;
+				pOutNoise[i] = GetNoise(x, y, maxX, maxY, octaveInputRange, octaveSeed);
+			}
+		}
+
+		/// <summary>
+		/// Fused GetOctaveNoiseRow: fills numRows octave rows over the same pixels in one pass. Each row gets
+		/// exactly what GetOctaveNoiseRow would write for it.
+		/// </summary>
+		static void GetOctaveNoiseRows([[maybe_unused]] RowCache& cache, const OctaveRow* pRows, size_t numRows, float startX, float stepX, float y, size_t count) noexcept
+		{
+			// Rows are set up and evaluated kMaxFusedRows at a time.
+			for (size_t firstRow = 0; firstRow < numRows; firstRow += kMaxFusedRows)
+			{
+				const size_t chunkRows = std::min(kMaxFusedRows, numRows - firstRow);
+				const OctaveRow* pChunk = pRows + firstRow;
+
+				float maxXs[kMaxFusedRows];
+				float inputRanges[kMaxFusedRows];
+				float gridYs[kMaxFusedRows];
+				unsigned int octaveInputRanges[kMaxFusedRows];
+				unsigned int octaveSeeds[kMaxFusedRows];
+
+				for (size_t row = 0; row < chunkRows; ++row)
+				{
+					const OctaveRow& octaveRow = pChunk[row];
+					octaveInputRanges[row] = GetOctaveInputRange(octaveRow.m_noiseInputRange, octaveRow.m_octave);
+					octaveSeeds[row] = GetOctaveSeed(octaveRow.m_seed, octaveRow.m_octave);
+					maxXs[row] = octaveRow.m_maxX;
+					inputRanges[row] = static_cast<float>(octaveInputRanges[row]);
+					gridYs[row] = (y / octaveRow.m_maxY) * inputRanges[row];
+				}
+
+				size_t i = 0;
+				for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				{
+					const Simd::FloatLanes columns = Simd::Add(Simd::SetFloat(static_cast<float>(i)), Simd::LaneIndices());
+					const Simd::FloatLanes xLanes = Simd::Add(Simd::SetFloat(startX), Simd::Mul(columns, Simd::SetFloat(stepX)));
+
+					for (size_t row = 0; row < chunkRows; ++row)
+					{
+						const Simd::FloatLanes gridX = Simd::Mul(Simd::Div(xLanes, Simd::SetFloat(maxXs[row])), Simd::SetFloat(inputRanges[row]));
+						Simd::StoreFloat(pChunk[row].m_pOutNoise + i, GetNoiseLanes(gridX, Simd::SetFloat(gridYs[row]), octaveSeeds[row]));
+					}
+				}
+
+				for (; i < count; ++i)
+				{
+					const float x = startX + static_cast<float>(i) * stepX;
+					for (size_t row = 0; row < chunkRows; ++row)
+					{
+						const OctaveRow& octaveRow = pChunk[row];
+						octaveRow.m_pOutNoise[i] = GetNoise(x, y, octaveRow.m_maxX, octaveRow.m_maxY, octaveInputRanges[row], octaveSeeds[row]);
+					}
+				}
+			}
+		}
+
+		/// <summary>
+		/// Blends numOctaves rows of raw octave noise (ppOctaveNoise[octave][i]) into pOutNoise exactly the way
+		/// GetAverageNoise does.
+		/// </summary>
+		static void BlendOctaves(const float* const* ppOctaveNoise, unsigned int numOctaves, float persistance, float* pOutNoise, size_t count) noexcept
+		{
+			if (numOctaves <= 0)
+			{
+				std::fill(pOutNoise, pOutNoise + count, 0.0f);
+				return;
+			}
+
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+			{
+				Simd::FloatLanes noise = Simd::SetFloat(0.0f);
+				float currentAmplitude = 1.0f;
+				float totalAmplitude = 0.0f;
+				for (unsigned int octave = 0; octave < numOctaves; ++octave)
+				{
+					totalAmplitude += currentAmplitude;
+					noise = Simd::Add(noise, Simd::Mul(Simd::LoadFloat(ppOctaveNoise[octave] + i), Simd::SetFloat(currentAmplitude)));
+					currentAmplitude *= persistance;
+				}
+
+				Simd::StoreFloat(pOutNoise + i, FinishAverageNoiseLanes(noise, totalAmplitude));
+			}
+
+			for (; i < count; ++i)
+			{
+				float noise = 0.0f;
+				float currentAmplitude = 1.0f;
+				float totalAmplitude = 0.0f;
+				for (unsigned int octave = 0; octave < numOctaves; ++octave)
+				{
+					totalAmplitude += currentAmplitude;
+					noise += ppOctaveNoise[octave][i] * currentAmplitude;
+					currentAmplitude *= persistance;
+				}
+
+				pOutNoise[i] = FinishAverageNoise(noise, totalAmplitude);
+			}
+		}
+
+		/// <summary>
+		/// Turns an amplitude weighted octave sum into the value GetAverageNoise returns. Monotonic in noise,
+		/// so it can also be applied to the ends of a range of possible sums (see OctaveCuller).
+		/// </summary>
+		static constexpr float FinishAverageNoise(float noise, float totalAmplitude) noexcept
+		{
+			noise /= totalAmplitude;
+
+			noise = Normalize(noise, -kAverageNoiseRange, kAverageNoiseRange);
+
+			// Same contrast curve as PerlinNoise.
+			noise = SmootherStep(noise);
+			return noise;
+		}
+
+		/// <summary>
+		/// FinishAverageNoise for a set of lanes.
+		/// </summary>
+		static Simd::FloatLanes FinishAverageNoiseLanes(Simd::FloatLanes noise, float totalAmplitude) noexcept
+		{
+			noise = Simd::Div(noise, Simd::SetFloat(totalAmplitude));
+
+			noise = Simd::Div(Simd::Sub(noise, Simd::SetFloat(-kAverageNoiseRange)), Simd::SetFloat(kAverageNoiseRange - -kAverageNoiseRange));
+
+			return Simd::SmootherStepLanes(noise);
+		}
+
+		//----------------------------------------------------------------------------------------------------
+		// Accessors
+		//----------------------------------------------------------------------------------------------------
+
+		unsigned int GetSeed() { return m_seed; }
+		void SetSeed(unsigned int seed) { m_seed = seed; }
+
+	private:
+
+		static constexpr float CornerContribution(int cornerX, int cornerY, float distanceX, float distanceY, unsigned int seed) noexcept
+		{
+			float falloff = kRadiusSquared - distanceX * distanceX - distanceY * distanceY;
+			falloff = (falloff > 0.0f) ? falloff : 0.0f;
+			falloff *= falloff;
+			falloff *= falloff;
+
+			// The top 4 bits of the hash pick the gradient.
+			const unsigned int gradient = (SquirrelNoise::Get2DNoise(cornerX, cornerY, seed) >> 28) << 1;
+			return falloff * (distanceX * kGradients[gradient] + distanceY * kGradients[gradient + 1]);
+		}
+
+		//----------------------------------------------------------------------------------------------------
+		// Lane Versions
+		// Mirror GetNoise and CornerContribution above, one point per lane.
+		//----------------------------------------------------------------------------------------------------
+
+		static Simd::FloatLanes GetNoiseLanes(Simd::FloatLanes x, Simd::FloatLanes y, unsigned int seedOverride) noexcept
+		{
+			const Simd::FloatLanes skew = Simd::Mul(Simd::Add(x, y), Simd::SetFloat(kSkew));
+			const Simd::IntLanes cellX = Simd::TruncateToInt(Simd::Add(x, skew));
+			const Simd::IntLanes cellY = Simd::TruncateToInt(Simd::Add(y, skew));
+
+			const Simd::FloatLanes unskew = Simd::Mul(Simd::IntToFloat(Simd::AddInt(cellX, cellY)), Simd::SetFloat(kUnskew));
+			const Simd::FloatLanes distanceX0 = Simd::Sub(x, Simd::Sub(Simd::IntToFloat(cellX), unskew));
+			const Simd::FloatLanes distanceY0 = Simd::Sub(y, Simd::Sub(Simd::IntToFloat(cellY), unskew));
+
+			// distanceX0 > distanceY0 exactly when distanceY0 - distanceX0 has its sign bit set.
+			const Simd::IntLanes middleOffsetX = Simd::ShiftRight<31>(Simd::AsInt(Simd::Sub(distanceY0, distanceX0)));
+			const Simd::IntLanes middleOffsetY = Simd::SubInt(Simd::SetInt(1), middleOffsetX);
+
+			const Simd::FloatLanes distanceX1 = Simd::Add(Simd::Sub(distanceX0, Simd::IntToFloat(middleOffsetX)), Simd::SetFloat(kUnskew));
+			const Simd::FloatLanes distanceY1 = Simd::Add(Simd::Sub(distanceY0, Simd::IntToFloat(middleOffsetY)), Simd::SetFloat(kUnskew));
+			const Simd::FloatLanes distanceX2 = Simd::Add(Simd::Sub(distanceX0, Simd::SetFloat(1.0f)), Simd::SetFloat(2.0f * kUnskew));
+			const Simd::FloatLanes distanceY2 = Simd::Add(Simd::Sub(distanceY0, Simd::SetFloat(1.0f)), Simd::SetFloat(2.0f * kUnskew));
+
+			const Simd::IntLanes one = Simd::SetInt(1);
+			Simd::FloatLanes noise = CornerContributionLanes(cellX, cellY, distanceX0, distanceY0, seedOverride);
+			noise = Simd::Add(noise, CornerContributionLanes(Simd::AddInt(cellX, middleOffsetX), Simd::AddInt(cellY, middleOffsetY), distanceX1, distanceY1, seedOverride));
+			noise = Simd::Add(noise, CornerContributionLanes(Simd::AddInt(cellX, one), Simd::AddInt(cellY, one), distanceX2, distanceY2, seedOverride));
+			return Simd::Mul(noise, Simd::SetFloat(kScale));
+		}
+
+		static Simd::FloatLanes CornerContributionLanes(Simd::IntLanes cornerX, Simd::IntLanes cornerY, Simd::FloatLanes distanceX, Simd::FloatLanes distanceY, unsigned int seed) noexcept
+		{
+			Simd::FloatLanes falloff = Simd::Sub(Simd::Sub(Simd::SetFloat(kRadiusSquared), Simd::Mul(distanceX, distanceX)), Simd::Mul(distanceY, distanceY));
+			falloff = Simd::Max(falloff, Simd::SetFloat(0.0f));
+			falloff = Simd::Mul(falloff, falloff);
+			falloff = Simd::Mul(falloff, falloff);
+
+			const Simd::IntLanes gradient = Simd::ShiftLeft<1>(Simd::ShiftRight<28>(SquirrelNoise::Get2DNoiseLanes(cornerX, cornerY, seed)));
+			const Simd::FloatLanes dot = Simd::Add(Simd::Mul(distanceX, Simd::Gather(kGradients, gradient)),
+				Simd::Mul(distanceY, Simd::Gather(kGradients + 1, gradient)));
+			return Simd::Mul(falloff, dot);
+		}
+	};
+}
\ No newline at end of file
@@ -1,4 +1,7 @@
 #pragma once
+#include "Utilities/Math/Simd.h"
+
+#include <cstddef>
 
 namespace Exelius
 {
@@ -150,6 +153,153 @@ namespace Exelius
 		{
 			return GetSignedUniform3DNoise(x, y, z, m_seed);
 		}
+#pragma endregion
+		//----------------------------------------------------------------------------------------------------
+		// Lane Noise Functions
+		// These hash Simd::kLaneCount coordinates at once and match the scalar functions above bit for bit.
+		//----------------------------------------------------------------------------------------------------
+#pragma region Lane Noise
+		static Simd::IntLanes Get1DNoiseLanes(Simd::IntLanes x, unsigned int seedOverride) noexcept
+		{
+			Simd::IntLanes mangledBits = Simd::MulInt(x, Simd::SetInt(kBitNoise));
+			mangledBits = Simd::AddInt(mangledBits, Simd::SetInt(seedOverride));
+			mangledBits = Simd::Xor(mangledBits, Simd::ShiftRight<8>(mangledBits));
+			mangledBits = Simd::MulInt(mangledBits, Simd::SetInt(kBitNoise1));
+			mangledBits = Simd::Xor(mangledBits, Simd::ShiftLeft<8>(mangledBits));
+			mangledBits = Simd::MulInt(mangledBits, Simd::SetInt(kBitNoise2));
+			mangledBits = Simd::Xor(mangledBits, Simd::ShiftRight<8>(mangledBits));
+
+			return mangledBits;
+		}
+
+		static Simd::FloatLanes GetUniform1DNoiseLanes(Simd::IntLanes x, unsigned int seedOverride) noexcept
+		{
+			const Simd::FloatLanes noise = Simd::UIntToFloat(Get1DNoiseLanes(x, seedOverride));
+			return Simd::Div(noise, Simd::SetFloat(static_cast<float>(0xffffffff)));
+		}
+
+		static Simd::IntLanes Get2DNoiseLanes(Simd::IntLanes x, Simd::IntLanes y, unsigned int seedOverride) noexcept
+		{
+			return Get1DNoiseLanes(Simd::AddInt(x, Simd::MulInt(Simd::SetInt(kPrime), y)), seedOverride);
+		}
+
+		static Simd::IntLanes Get3DNoiseLanes(Simd::IntLanes x, Simd::IntLanes y, Simd::IntLanes z, unsigned int seedOverride) noexcept
+		{
+			const Simd::IntLanes yOffset = Simd::MulInt(Simd::SetInt(kPrime), y);
+			const Simd::IntLanes zOffset = Simd::MulInt(Simd::SetInt(kPrime1), z);
+			return Get1DNoiseLanes(Simd::AddInt(Simd::AddInt(x, yOffset), zOffset), seedOverride);
+		}
+
+		static Simd::FloatLanes GetUniform3DNoiseLanes(Simd::IntLanes x, Simd::IntLanes y, Simd::IntLanes z, unsigned int seedOverride) noexcept
+		{
+			const Simd::FloatLanes noise = Simd::UIntToFloat(Get3DNoiseLanes(x, y, z, seedOverride));
+			const Simd::FloatLanes unitNoise = Simd::Div(noise, Simd::SetFloat(static_cast<float>(0xffffffff)));
+			return Simd::Sub(Simd::Mul(Simd::SetFloat(2.f), unitNoise), Simd::SetFloat(1.0f));
+		}
+#pragma endregion
+		//----------------------------------------------------------------------------------------------------
+		// Bulk Noise Functions
+		// Hash a whole span per call, Simd::kLaneCount values at a time. Every output is bit for bit what
+		// the scalar function of the same name returns for that element.
+		//----------------------------------------------------------------------------------------------------
+#pragma region Bulk Noise
+		static void Get1DNoise(const int* pX, unsigned int* pOutNoise, size_t count, unsigned int seedOverride) noexcept
+		{
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				Simd::StoreInt(pOutNoise + i, Get1DNoiseLanes(Simd::LoadInt(pX + i), seedOverride));
+
+			for (; i < count; ++i)
+				pOutNoise[i] = Get1DNoise(pX[i], seedOverride);
+		}
+
+		static void Get2DNoise(const int* pX, const int* pY, unsigned int* pOutNoise, size_t count, unsigned int seedOverride) noexcept
+		{
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				Simd::StoreInt(pOutNoise + i, Get2DNoiseLanes(Simd::LoadInt(pX + i), Simd::LoadInt(pY + i), seedOverride));
+
+			for (; i < count; ++i)
+				pOutNoise[i] = Get2DNoise(pX[i], pY[i], seedOverride);
+		}
+
+		static void Get3DNoise(const int* pX, const int* pY, const int* pZ, unsigned int* pOutNoise, size_t count, unsigned int seedOverride) noexcept
+		{
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				Simd::StoreInt(pOutNoise + i, Get3DNoiseLanes(Simd::LoadInt(pX + i), Simd::LoadInt(pY + i), Simd::LoadInt(pZ + i), seedOverride));
+
+			for (; i < count; ++i)
+				pOutNoise[i] = Get3DNoise(pX[i], pY[i], pZ[i], seedOverride);
+		}
+
+		static void GetUniform1DNoise(const int* pX, float* pOutNoise, size_t count, unsigned int seedOverride) noexcept
+		{
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				Simd::StoreFloat(pOutNoise + i, GetUniform1DNoiseLanes(Simd::LoadInt(pX + i), seedOverride));
+
+			for (; i < count; ++i)
+				pOutNoise[i] = GetUniform1DNoise(pX[i], seedOverride);
+		}
+
+		static void GetUniform3DNoise(const int* pX, const int* pY, const int* pZ, float* pOutNoise, size_t count, unsigned int seedOverride) noexcept
+		{
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				Simd::StoreFloat(pOutNoise + i, GetUniform3DNoiseLanes(Simd::LoadInt(pX + i), Simd::LoadInt(pY + i), Simd::LoadInt(pZ + i), seedOverride));
+
+			for (; i < count; ++i)
+				pOutNoise[i] = GetUniform3DNoise(pX[i], pY[i], pZ[i], seedOverride);
+		}
+
+		//----------------------------------------------------------------------------------------------------
+		// Sequences
+		// The same, for consecutive coordinates (firstX, firstX + 1, ...) so callers don't need to build
+		// an index array. Handy for one draw per tile index.
+		//----------------------------------------------------------------------------------------------------
+
+		/// <summary>
+		/// pOutNoise[i] = Get1DNoise(firstX + i, seedOverride).
+		/// </summary>
+		static void Get1DNoiseSequence(int firstX, unsigned int* pOutNoise, size_t count, unsigned int seedOverride) noexcept
+		{
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				Simd::StoreInt(pOutNoise + i, Get1DNoiseLanes(SequenceLanes(firstX, i), seedOverride));
+
+			for (; i < count; ++i)
+				pOutNoise[i] = Get1DNoise(SequenceValue(firstX, i), seedOverride);
+		}
+
+		/// <summary>
+		/// pOutNoise[i] = GetUniform1DNoise(firstX + i, seedOverride).
+		/// </summary>
+		static void GetUniform1DNoiseSequence(int firstX, float* pOutNoise, size_t count, unsigned int seedOverride) noexcept
+		{
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				Simd::StoreFloat(pOutNoise + i, GetUniform1DNoiseLanes(SequenceLanes(firstX, i), seedOverride));
+
+			for (; i < count; ++i)
+				pOutNoise[i] = GetUniform1DNoise(SequenceValue(firstX, i), seedOverride);
+		}
+
+		/// <summary>
+		/// pOutNoise[i] = GetUniform3DNoise(x, firstY + i, z, seedOverride).
+		/// </summary>
+		static void GetUniform3DNoiseSequenceY(int x, int firstY, int z, float* pOutNoise, size_t count, unsigned int seedOverride) noexcept
+		{
+			const Simd::IntLanes xLanes = Simd::SetInt(static_cast<unsigned int>(x));
+			const Simd::IntLanes zLanes = Simd::SetInt(static_cast<unsigned int>(z));
+
+			size_t i = 0;
+			for (const size_t laneEnd = count - (count % Simd::kLaneCount); i < laneEnd; i += Simd::kLaneCount)
+				Simd::StoreFloat(pOutNoise + i, GetUniform3DNoiseLanes(xLanes, SequenceLanes(firstY, i), zLanes, seedOverride));
+
+			for (; i < count; ++i)
+				pOutNoise[i] = GetUniform3DNoise(x, SequenceValue(firstY, i), z, seedOverride);
+		}
 #pragma endregion
 		//----------------------------------------------------------------------------------------------------
 		// Accessors
@@ -157,5 +307,18 @@ namespace Exelius
 
 		unsigned int GetSeed() { return m_seed; }
 		void SetSeed(unsigned int seed) { m_seed = seed; }
+
+	private:
+
+		// first + offset with unsigned wrap around, the same bits the hash would see from int arithmetic.
+		static constexpr int SequenceValue(int first, size_t offset) noexcept
+		{
+			return static_cast<int>(static_cast<unsigned int>(first) + static_cast<unsigned int>(offset));
+		}
+
+		static Simd::IntLanes SequenceLanes(int first, size_t offset) noexcept
+		{
+			return Simd::AddInt(Simd::SetInt(static_cast<unsigned int>(SequenceValue(first, offset))), Simd::IntLaneIndices());
+		}
 	};
 }
\ No newline at end of file
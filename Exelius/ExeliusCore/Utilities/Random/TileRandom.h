@@ -0,0 +1,60 @@
+#pragma once
+#include "Utilities/Random/Noise/SquirrelNoise.h"
+
+#include <cstddef>
+
+namespace Exelius
+{
+	/// <summary>
+	/// Counter-based random numbers for per-tile decisions. A value is a pure hash of (seed, stage, index, draw),
+	/// so there is no state to share between threads. Results do not depend on which thread handles which
+	/// tile or in what order, which keeps parallel generation identical for a seed.
+	///
+	/// Use one stage per pass over the map (salting, each cellular automata iteration...) so passes don't
+	/// reuse each other's values for the same tile.
+	///
+	/// \b Example:
+	/// ~~~~~
+	/// const TileRandom salt = TileRandom(worldSeed).GetStage(kSaltStage);
+	/// if (salt.GetFloat(tileIndex) <= chance)
+	///		...
+	/// ~~~~~
+	/// </summary>
+	class TileRandom
+	{
+		unsigned int m_seed;
+
+	public:
+		constexpr explicit TileRandom(unsigned int seed = 0) noexcept
+			: m_seed(seed)
+		{
+			//
+		}
+
+		/// <summary>
+		/// The generator for one stage of this one. Different stages give independent values for the same index.
+		/// </summary>
+		constexpr TileRandom GetStage(unsigned int stage) const noexcept
+		{
+			return TileRandom(SquirrelNoise::Get1DNoise(static_cast<int>(stage), m_seed));
+		}
+
+		/// <summary>
+		/// Uniform value in [0, 1] for a tile. draw picks between several independent values for the same tile.
+		/// </summary>
+		constexpr float GetFloat(size_t index, unsigned int draw = 0) const noexcept
+		{
+			return SquirrelNoise::GetUniform2DNoise(static_cast<int>(index), static_cast<int>(draw), m_seed);
+		}
+
+		/// <summary>
+		/// pOutValues[i] = GetFloat(firstIndex + i) for a run of tiles, evaluated in SIMD lanes.
+		/// </summary>
+		void GetFloats(size_t firstIndex, float* pOutValues, size_t count) const noexcept
+		{
+			SquirrelNoise::GetUniform1DNoiseSequence(static_cast<int>(firstIndex), pOutValues, count, m_seed);
+		}
+
+		constexpr unsigned int GetSeed() const noexcept { return m_seed; }
+	};
+}
\ No newline at end of file
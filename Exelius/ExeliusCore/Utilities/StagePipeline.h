@@ -0,0 +1,190 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//Exelius Engine namespace. Used for all Engine related code.
+namespace Exelius
+{
+	/// <summary>
+	/// FNV-1a hash of a sequence of plain values. StagePipeline keys every stage output with one.
+	/// </summary>
+	class StageKey
+	{
+		static constexpr uint64_t kOffsetBasis = 14695981039346656037ull;
+		static constexpr uint64_t kPrime = 1099511628211ull;
+
+		uint64_t m_hash;
+
+	public:
+		StageKey()
+			: m_hash(kOffsetBasis)
+		{
+			//
+		}
+
+		/// <summary>
+		/// Mix the bytes of value into the key. Only for types without padding (numbers, enums, keys).
+		/// </summary>
+		template <class Value>
+		StageKey& Add(const Value& value)
+		{
+			static_assert(std::is_trivially_copyable_v<Value>, "Stage keys can only hash plain values.");
+
+			unsigned char bytes[sizeof(Value)];
+			std::memcpy(bytes, &value, sizeof(Value));
+			for (unsigned char byte : bytes)
+			{
+				m_hash = (m_hash ^ byte) * kPrime;
+			}
+			return *this;
+		}
+
+		uint64_t Get() const { return m_hash; }
+	};
+
+	/// <summary>
+	/// A fixed chain of processing stages with declared inputs, where a stage only runs again when something
+	/// it depends on changed.
+	///
+	/// A stage is a name and the stages it reads. Its output lives with whoever owns the pipeline, the
+	/// pipeline keeps the key it was made with: the hash of the stage's own parameters and the keys of its
+	/// inputs. Prepare works out every key and marks the stages whose key differs from their output's as
+	/// dirty, so a change to one stage's parameters dirties it and everything downstream of it, and nothing
+	/// upstream. Run then runs the dirty stages in order.
+	///
+	/// Stages have to be added after the stages they read, so the order they were added in is a valid run
+	/// order. The pipeline holds no callbacks, the owner passes them to Prepare and Run, so it can be copied
+	/// along with its owner.
+	///
+	/// \b Example:
+	/// ~~~~~
+	/// const size_t height = pipeline.AddStage("Height", {});
+	/// const size_t biome = pipeline.AddStage("Biome", { height });
+	/// pipeline.Prepare([&](size_t stage, StageKey& key) { if (stage == height) key.Add(heightSeed); });
+	/// pipeline.Run([&](size_t stage) { ... });
+	/// ~~~~~
+	/// </summary>
+	class StagePipeline
+	{
+		struct Stage
+		{
+			const char* m_pName;
+			std::vector<size_t> m_inputs;
+
+			// Key of the output that exists, and the key Prepare worked out for the current parameters.
+			uint64_t m_outputKey = 0;
+			uint64_t m_currentKey = 0;
+			bool m_hasOutput = false;
+			bool m_isDirty = true;
+
+			// Whether the last Run ran the stage, and how long it took.
+			bool m_didRun = false;
+			double m_lastSeconds = 0.0;
+		};
+
+		std::vector<Stage> m_stages;
+
+	public:
+		/// <summary>
+		/// Add a stage that reads the outputs of inputs.
+		/// </summary>
+		/// <param name="pName">(const char*) Name for timings and debugging.</param>
+		/// <param name="inputs">(std::initializer_list<size_t>) Stages this stage reads, all added before it.</param>
+		/// <returns>(size_t) The stage's id, the order it was added in.</returns>
+		size_t AddStage(const char* pName, std::initializer_list<size_t> inputs)
+		{
+			Stage stage;
+			stage.m_pName = pName;
+			stage.m_inputs.assign(inputs.begin(), inputs.end());
+
+			m_stages.push_back(std::move(stage));
+			return m_stages.size() - 1;
+		}
+
+		/// <summary>
+		/// Work out the key of every stage for the current parameters and mark the stages that have to run.
+		/// </summary>
+		/// <param name="addParameters">(const Function&) Called as addParameters(size_t stage, StageKey& key), adds every
+		/// parameter the stage's output depends on besides its inputs.</param>
+		template <class Function>
+		void Prepare(const Function& addParameters)
+		{
+			for (size_t stageId = 0; stageId < m_stages.size(); ++stageId)
+			{
+				Stage& stage = m_stages[stageId];
+
+				StageKey key;
+				addParameters(stageId, key);
+				for (size_t input : stage.m_inputs)
+				{
+					key.Add(m_stages[input].m_currentKey);
+				}
+
+				stage.m_currentKey = key.Get();
+				stage.m_isDirty = !stage.m_hasOutput || stage.m_currentKey != stage.m_outputKey;
+			}
+		}
+
+		/// <summary>
+		/// Run every dirty stage in order. Prepare has to be called first.
+		/// </summary>
+		/// <param name="runStage">(const Function&) Called as runStage(size_t stage), makes the stage's output from its inputs.</param>
+		template <class Function>
+		void Run(const Function& runStage)
+		{
+			using Clock = std::chrono::steady_clock;
+
+			for (size_t stageId = 0; stageId < m_stages.size(); ++stageId)
+			{
+				Stage& stage = m_stages[stageId];
+				stage.m_didRun = stage.m_isDirty;
+				stage.m_lastSeconds = 0.0;
+				if (!stage.m_isDirty)
+					continue;
+
+				const auto stageStart = Clock::now();
+				runStage(stageId);
+				stage.m_lastSeconds = std::chrono::duration<double>(Clock::now() - stageStart).count();
+
+				stage.m_outputKey = stage.m_currentKey;
+				stage.m_hasOutput = true;
+				stage.m_isDirty = false;
+			}
+		}
+
+		/// <summary>
+		/// Forget every output, the next Run runs every stage.
+		/// </summary>
+		void Invalidate()
+		{
+			for (Stage& stage : m_stages)
+			{
+				stage.m_hasOutput = false;
+			}
+		}
+
+		/// <summary>
+		/// True if the stage will run in the next Run. Only valid after Prepare.
+		/// </summary>
+		bool IsDirty(size_t stage) const { return m_stages[stage].m_isDirty; }
+
+		/// <summary>
+		/// True if the last Run ran the stage, false if its cached output was used.
+		/// </summary>
+		bool DidRun(size_t stage) const { return m_stages[stage].m_didRun; }
+
+		/// <summary>
+		/// Wall-clock seconds the stage took in the last Run, 0 if it didn't run.
+		/// </summary>
+		double GetStageSeconds(size_t stage) const { return m_stages[stage].m_lastSeconds; }
+
+		const char* GetStageName(size_t stage) const { return m_stages[stage].m_pName; }
+		size_t GetStageCount() const { return m_stages.size(); }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+
+namespace Exelius
+{
+	std::atomic<bool> TraceRecorder::s_enabled = false;
+	thread_local TraceRecorder::ThreadBuffer* TraceRecorder::s_pThreadBuffer = nullptr;
+
+	/// <summary>
+	/// Write a string as a JSON string, quotes included.
+	/// </summary>
+	static void WriteJsonString(std::FILE* pFile, const char* pString)
+	{
+		std::fputc('"', pFile);
+		for (const char* pChar = pString; *pChar; ++pChar)
+		{
+			if (*pChar == '"' || *pChar == '\\')
+				std::fputc('\\', pFile);
+			if ((unsigned char)*pChar >= 0x20)
+				std::fputc(*pChar, pFile);
+		}
+		std::fputc('"', pFile);
+	}
+
+	TraceRecorder::TraceRecorder()
+		: m_epoch(std::chrono::steady_clock::now())
+	{
+		//
+	}
+
+	TraceRecorder& TraceRecorder::GetInstance()
+	{
+		static TraceRecorder* s_pInstance = new TraceRecorder();
+		return *s_pInstance;
+	}
+
+	void TraceRecorder::Record(const char* pName, int64_t beginNanoseconds, int64_t endNanoseconds)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+		if (buffer.m_events.empty())
+			buffer.m_events.resize(kEventsPerThread);
+
+		// Only this thread writes the buffer.
+		const uint64_t numRecorded = buffer.m_numRecorded.load(std::memory_order_relaxed);
+		buffer.m_events[numRecorded % kEventsPerThread] = { pName, beginNanoseconds, endNanoseconds };
+		buffer.m_numRecorded.store(numRecorded + 1, std::memory_order_release);
+	}
+
+	void TraceRecorder::SetCurrentThreadName(const std::string& name)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		std::lock_guard<std::mutex> lock(m_bufferLock);
+		buffer.m_threadName = name;
+	}
+
+	void TraceRecorder::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_bufferLock);
+		for (const std::unique_ptr<ThreadBuffer>& pBuffer : m_buffers)
+		{
+			pBuffer->m_numRecorded.store(0, std::memory_order_release);
+		}
+	}
+
+	size_t TraceRecorder::GetEventCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_bufferLock);
+
+		size_t numEvents = 0;
+		for (const std::unique_ptr<ThreadBuffer>& pBuffer : m_buffers)
+		{
+			const uint64_t numRecorded = pBuffer->m_numRecorded.load(std::memory_order_acquire);
+			numEvents += (size_t)std::min<uint64_t>(numRecorded, kEventsPerThread);
+		}
+		return numEvents;
+	}
+
+	bool TraceRecorder::WriteChromeTrace(const char* pPath) const
+	{
+		std::FILE* pFile = std::fopen(pPath, "w");
+		if (!pFile)
+			return false;
+
+		WriteChromeTrace(pFile);
+		return std::fclose(pFile) == 0;
+	}
+
+	void TraceRecorder::WriteChromeTrace(std::FILE* pFile) const
+	{
+		std::lock_guard<std::mutex> lock(m_bufferLock);
+
+		// Timestamps and durations are in microseconds, the trace viewers show them with displayTimeUnit.
+		std::fprintf(pFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+		bool isFirst = true;
+		for (const std::unique_ptr<ThreadBuffer>& pBuffer : m_buffers)
+		{
+			const ThreadBuffer& buffer = *pBuffer;
+
+			std::fprintf(pFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", isFirst ? "" : ",\n", buffer.m_threadId);
+			if (buffer.m_threadName.empty())
+				std::fprintf(pFile, "\"Thread %u\"", buffer.m_threadId);
+			else
+				WriteJsonString(pFile, buffer.m_threadName.c_str());
+			std::fprintf(pFile, "}}");
+			isFirst = false;
+
+			// Oldest event still in the ring first.
+			const uint64_t numRecorded = buffer.m_numRecorded.load(std::memory_order_acquire);
+			const uint64_t numEvents = std::min<uint64_t>(numRecorded, buffer.m_events.size());
+			for (uint64_t i = numRecorded - numEvents; i < numRecorded; ++i)
+			{
+				const Event& event = buffer.m_events[i % kEventsPerThread];
+
+				std::fprintf(pFile, ",\n{\"name\":");
+				WriteJsonString(pFile, event.m_pName);
+				std::fprintf(pFile, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer.m_threadId,
+					(double)event.m_beginNanoseconds / 1000.0, (double)(event.m_endNanoseconds - event.m_beginNanoseconds) / 1000.0);
+			}
+		}
+
+		std::fprintf(pFile, "\n]}\n");
+	}
+
+	TraceRecorder::ThreadBuffer& TraceRecorder::GetThreadBuffer()
+	{
+		if (s_pThreadBuffer)
+			return *s_pThreadBuffer;
+
+		std::lock_guard<std::mutex> lock(m_bufferLock);
+		m_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+		m_buffers.back()->m_threadId = (unsigned int)m_buffers.size();
+
+		s_pThreadBuffer = m_buffers.back().get();
+		return *m_buffers.back();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//Exelius Engine namespace. Used for all Engine related code.
+namespace Exelius
+{
+	/// <summary>
+	/// Records named, timed scopes from every thread, for a timeline of where the time goes and how evenly
+	/// the job system threads are loaded. Written out in the Chrome trace event format, which about:tracing
+	/// and ui.perfetto.dev open.
+	///
+	/// Every thread records into its own ring buffer of kEventsPerThread events, so recording takes no lock
+	/// and a thread that records more than that keeps its newest events. Buffers are made the first time a
+	/// thread records, and kept (with their events) after the thread exits.
+	///
+	/// Recording is off until SetEnabled(true). While it is off a scope costs one relaxed atomic load.
+	/// Defining EXELIUS_DISABLE_TRACING compiles the scopes out.
+	///
+	/// Clear and WriteChromeTrace read every buffer without stopping the threads, so they should only be
+	/// called while nothing is being traced, or some events can come out torn.
+	///
+	/// \b Example:
+	/// ~~~~~
+	/// TraceRecorder::GetInstance().SetEnabled(true);
+	/// {
+	///		EXELIUS_TRACE_SCOPE("Generate");
+	///		...
+	/// }
+	/// TraceRecorder::GetInstance().WriteChromeTrace("trace.json");
+	/// ~~~~~
+	/// </summary>
+	class TraceRecorder
+	{
+	public:
+		/// <summary>
+		/// A finished scope. pName must outlive the recorder, scopes are named with string literals.
+		/// </summary>
+		struct Event
+		{
+			const char* m_pName;
+			int64_t m_beginNanoseconds;
+			int64_t m_endNanoseconds;
+		};
+
+		static constexpr size_t kEventsPerThread = (size_t)1 << 16;
+
+	private:
+		struct ThreadBuffer
+		{
+			unsigned int m_threadId = 0;
+			std::string m_threadName;
+			std::vector<Event> m_events;
+
+			// Events ever recorded. Only the newest kEventsPerThread are still in m_events.
+			std::atomic<uint64_t> m_numRecorded = 0;
+		};
+
+		static std::atomic<bool> s_enabled;
+
+		// The calling thread's buffer. Buffers are never freed, so this stays valid.
+		static thread_local ThreadBuffer* s_pThreadBuffer;
+
+		std::chrono::steady_clock::time_point m_epoch;
+
+		mutable std::mutex m_bufferLock;
+		std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+	public:
+		TraceRecorder();
+
+		TraceRecorder(const TraceRecorder&) = delete;
+		TraceRecorder(TraceRecorder&&) = delete;
+		TraceRecorder& operator=(const TraceRecorder&) = delete;
+		TraceRecorder& operator=(TraceRecorder&&) = delete;
+
+		/// <summary>
+		/// Get the engine trace recorder. It is never destroyed, so threads can record until the program exits.
+		/// </summary>
+		/// <returns>(TraceRecorder&) The engine trace recorder.</returns>
+		static TraceRecorder& GetInstance();
+
+		/// <summary>
+		/// Start or stop recording. Events recorded so far are kept, scopes still open when it stops are dropped.
+		/// </summary>
+		void SetEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+		static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Nanoseconds since the recorder was made.
+		/// </summary>
+		int64_t GetTimestamp() const
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+		}
+
+		/// <summary>
+		/// Add an event to the calling thread's buffer.
+		/// </summary>
+		void Record(const char* pName, int64_t beginNanoseconds, int64_t endNanoseconds);
+
+		/// <summary>
+		/// Name the calling thread in the trace. Threads that aren't named show up as "Thread <id>".
+		/// </summary>
+		void SetCurrentThreadName(const std::string& name);
+
+		/// <summary>
+		/// Drop every recorded event.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Events that are in the buffers, over every thread.
+		/// </summary>
+		size_t GetEventCount() const;
+
+		/// <summary>
+		/// Write every buffered event as a Chrome trace JSON object, one complete ("X") event per scope.
+		/// </summary>
+		/// <returns>(bool) False if the file could not be written.</returns>
+		bool WriteChromeTrace(const char* pPath) const;
+		void WriteChromeTrace(std::FILE* pFile) const;
+
+	private:
+		ThreadBuffer& GetThreadBuffer();
+	};
+
+	/// <summary>
+	/// Records the time from its construction to its destruction as one event, if the recorder was enabled
+	/// for all of it. Use EXELIUS_TRACE_SCOPE rather than naming one.
+	/// </summary>
+	class TraceScope
+	{
+		const char* m_pName;
+		int64_t m_beginNanoseconds;
+
+	public:
+		explicit TraceScope(const char* pName)
+			: m_pName(pName)
+			, m_beginNanoseconds(-1)
+		{
+			if (TraceRecorder::IsEnabled())
+				m_beginNanoseconds = TraceRecorder::GetInstance().GetTimestamp();
+		}
+
+		~TraceScope()
+		{
+			if (m_beginNanoseconds < 0 || !TraceRecorder::IsEnabled())
+				return;
+
+			TraceRecorder& recorder = TraceRecorder::GetInstance();
+			recorder.Record(m_pName, m_beginNanoseconds, recorder.GetTimestamp());
+		}
+
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+	};
+}
+
+#define EXELIUS_TRACE_CONCAT_INNER(a, b) a##b
+#define EXELIUS_TRACE_CONCAT(a, b) EXELIUS_TRACE_CONCAT_INNER(a, b)
+
+#ifndef EXELIUS_DISABLE_TRACING
+	// Trace the rest of the enclosing scope as pName (a string literal).
+	#define EXELIUS_TRACE_SCOPE(pName) const Exelius::TraceScope EXELIUS_TRACE_CONCAT(traceScope, __LINE__)(pName)
+#else
+	#define EXELIUS_TRACE_SCOPE(pName) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,533 @@
+#include <Utilities/JobSystem.h>
+#include <Utilities/Random/Noise/PerlinNoise.h>
+#include <Utilities/Random/Noise/SimplexNoise.h>
+#include <World/GenertionSettings/GeneratorConfig.h>
+#include <World/TileMap/TileMap.h>
+#include <World/WorldGeneration/ChunkedWorld.h>
+#include <World/WorldGeneration/ProgressiveWorldGenerator.h>
+#include <World/WorldGeneration/WorldGenerator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless generator benchmark. Measures how fast each noise backend fills a world sized map, how that
+// scales with octave count and input range, and where WorldGenerator spends its time.
+//
+// Usage: NoiseBenchmark [passes] [--json <file>]
+//		passes		Number of timed passes per measurement (default 10).
+//		--json		Also write the results as JSON to <file>, or to stdout when <file> is "-".
+
+static constexpr unsigned int kMapWidth = kWorldWidth;
+static constexpr unsigned int kMapHeight = kWorldHeight;
+static constexpr float kNoiseDivisor = 2.0f;
+static constexpr float kPersistance = 0.5f;
+static constexpr unsigned int kSeed = 1234567;
+
+// The SandboxApp height map settings.
+static constexpr unsigned int kDefaultOctaves = 6;
+static constexpr unsigned int kDefaultInputRange = 2;
+
+static constexpr unsigned int kSweepOctaves[] = { 1, 2, 4, 6, 8 };
+static constexpr unsigned int kSweepInputRanges[] = { 1, 2, 4, 8, 16 };
+
+static constexpr unsigned int kDefaultPasses = 10;
+
+// Chunk streaming: a window sized view pans diagonally over a world much larger than the cache budget.
+static constexpr unsigned int kStreamingWorldChunks = 32;
+static constexpr unsigned int kStreamingSteps = 48;
+static constexpr int kStreamingStepTiles = 64;
+static constexpr size_t kStreamingMemoryBudget = (size_t)16 * 1024 * 1024;
+
+struct NoiseSettings
+{
+	unsigned int m_octaves;
+	unsigned int m_inputRange;
+};
+
+struct BenchmarkResult
+{
+	double m_bestSeconds = 0.0;
+	double m_averageSeconds = 0.0;
+	float m_checksum = 0.0f;
+};
+
+struct NoiseResult
+{
+	const char* m_pBackend;
+	const char* m_pPath;
+	NoiseSettings m_settings;
+	BenchmarkResult m_result;
+};
+
+struct WorldResult
+{
+	const char* m_pBackend;
+	bool m_cullHeightOctaves;
+	double m_bestSeconds = 0.0;
+
+	// Averages over the timed passes.
+	WorldGenerationTimings m_averageTimings;
+};
+
+struct StreamingResult
+{
+	unsigned int m_worldWidth = 0;
+	unsigned int m_worldHeight = 0;
+	size_t m_generatedChunks = 0;
+	double m_chunkSeconds = 0.0;
+	double m_totalSeconds = 0.0;
+	size_t m_peakCachedBytes = 0;
+};
+
+struct ProgressiveResult
+{
+	// Averages over the timed passes. Start returns once the first level is done.
+	double m_levelSeconds[ProgressiveWorldGenerator<Exelius::PerlinNoise>::kNumLevels] = {};
+	double m_startSeconds = 0.0;
+	double m_finalSeconds = 0.0;
+};
+
+struct MoistureEditResult
+{
+	// Averages over the timed passes.
+	double m_fullSeconds = 0.0;
+	double m_editSeconds = 0.0;
+
+	// Which stages the edit reran, indexed by WorldGenerator's PipelineStage.
+	bool m_stageRan[WorldGenerator<Exelius::PerlinNoise>::kNumPipelineStages] = {};
+};
+
+template <class Function>
+static BenchmarkResult TimePasses(unsigned int passes, Function&& fillMap)
+{
+	std::vector<float> map((size_t)kMapWidth * (size_t)kMapHeight);
+
+	// Warm up caches and page in the map before timing.
+	fillMap(map.data());
+
+	BenchmarkResult result;
+	double totalSeconds = 0.0;
+	for (unsigned int pass = 0; pass < passes; ++pass)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		fillMap(map.data());
+		const auto end = std::chrono::steady_clock::now();
+
+		const double seconds = std::chrono::duration<double>(end - start).count();
+		totalSeconds += seconds;
+		if (pass == 0 || seconds < result.m_bestSeconds)
+			result.m_bestSeconds = seconds;
+	}
+	result.m_averageSeconds = totalSeconds / (double)passes;
+
+	// Keeps the work observable so the optimizer can't drop it.
+	for (float value : map)
+		result.m_checksum += value;
+
+	return result;
+}
+
+/// <summary>
+/// One GetAverageNoise call per pixel.
+/// </summary>
+template <class NoiseBackend>
+static BenchmarkResult RunScalarBenchmark(unsigned int passes, NoiseSettings settings)
+{
+	return TimePasses(passes, [settings](float* pMap)
+	{
+		for (unsigned int y = 0; y < kMapHeight; ++y)
+		{
+			for (unsigned int x = 0; x < kMapWidth; ++x)
+			{
+				pMap[(size_t)y * kMapWidth + x] = NoiseBackend::GetAverageNoise((float)x, (float)y,
+					(float)kMapWidth / kNoiseDivisor, (float)kMapHeight / kNoiseDivisor, settings.m_inputRange, settings.m_octaves, kPersistance, kSeed);
+			}
+		}
+	});
+}
+
+/// <summary>
+/// One GetAverageNoiseRow call per row, the way the generators use the backends.
+/// </summary>
+template <class NoiseBackend>
+static BenchmarkResult RunRowBenchmark(unsigned int passes, NoiseSettings settings)
+{
+	return TimePasses(passes, [settings](float* pMap)
+	{
+		typename NoiseBackend::RowCache cache;
+		for (unsigned int y = 0; y < kMapHeight; ++y)
+		{
+			NoiseBackend::GetAverageNoiseRow(cache, 0.0f, 1.0f, (float)y, pMap + (size_t)y * kMapWidth, kMapWidth,
+				(float)kMapWidth / kNoiseDivisor, (float)kMapHeight / kNoiseDivisor, settings.m_inputRange, settings.m_octaves, kPersistance, kSeed);
+		}
+	});
+}
+
+/// <summary>
+/// Full GenerateWorld calls on a window sized map. Every pass picks new noise seeds (like the regenerate
+/// key in SandboxApp), so every octave is generated instead of re-blended.
+/// </summary>
+template <class NoiseBackend>
+static WorldResult RunWorldBenchmark(unsigned int passes, const char* pBackend, bool cullHeightOctaves)
+{
+	TileMap map(kMapWidth, kMapHeight, 1, 1);
+	WorldGenerator<NoiseBackend> generator(kSeed);
+	generator.SetHeightOctaveCulling(cullHeightOctaves);
+
+	// Warm up.
+	generator.GenerateWorld(map);
+
+	WorldResult result;
+	result.m_pBackend = pBackend;
+	result.m_cullHeightOctaves = cullHeightOctaves;
+
+	WorldGenerationTimings& average = result.m_averageTimings;
+	for (unsigned int pass = 0; pass < passes; ++pass)
+	{
+		map.ResetMap();
+		generator.ResetGenerator();
+		generator.GenerateWorld(map);
+
+		const WorldGenerationTimings& timings = generator.GetLastTimings();
+		average.m_noiseSeconds += timings.m_noiseSeconds;
+		average.m_biomeSeconds += timings.m_biomeSeconds;
+		average.m_saltSeconds += timings.m_saltSeconds;
+		average.m_growFloraSeconds += timings.m_growFloraSeconds;
+		average.m_totalSeconds += timings.m_totalSeconds;
+
+		if (pass == 0 || timings.m_totalSeconds < result.m_bestSeconds)
+			result.m_bestSeconds = timings.m_totalSeconds;
+	}
+
+	average.m_noiseSeconds /= (double)passes;
+	average.m_biomeSeconds /= (double)passes;
+	average.m_saltSeconds /= (double)passes;
+	average.m_growFloraSeconds /= (double)passes;
+	average.m_totalSeconds /= (double)passes;
+
+	return result;
+}
+
+/// <summary>
+/// A moisture persistance change on a generated world, like tweaking the moisture settings in SandboxApp.
+/// Only the moisture stage and the stages after it should run again, the height and tempurature planes
+/// come from the cache.
+/// </summary>
+template <class NoiseBackend>
+static MoistureEditResult RunMoistureEditBenchmark(unsigned int passes)
+{
+	using Generator = WorldGenerator<NoiseBackend>;
+
+	TileMap map(kMapWidth, kMapHeight, 1, 1);
+	Generator generator(kSeed);
+
+	MoistureEditResult result;
+	for (unsigned int pass = 0; pass < passes; ++pass)
+	{
+		generator.ResetGenerator();
+		generator.GenerateWorld(map);
+		result.m_fullSeconds += generator.GetLastTimings().m_totalSeconds;
+
+		NoiseParameters& moisture = generator.GetMoistureParameters();
+		moisture.SetParameters(moisture.GetOctaves(), moisture.GetInputRange(), moisture.GetPersistance() * 0.5f, moisture.GetSeed());
+		generator.GenerateWorld(map);
+		result.m_editSeconds += generator.GetLastTimings().m_totalSeconds;
+	}
+
+	for (size_t stage = 0; stage < Generator::kNumPipelineStages; ++stage)
+		result.m_stageRan[stage] = generator.GetPipeline().DidRun(stage);
+
+	result.m_fullSeconds /= (double)passes;
+	result.m_editSeconds /= (double)passes;
+	return result;
+}
+
+/// <summary>
+/// ChunkedWorld following a view that pans across the world. Every step calls Update until the view and
+/// its prefetch ring are streamed in, like a game that waits a few frames. The generation time per chunk
+/// should not depend on the world size, and the cache should stay at the budget.
+/// </summary>
+template <class NoiseBackend>
+static StreamingResult RunStreamingBenchmark()
+{
+	ChunkedWorld<NoiseBackend> world(kSeed, kStreamingWorldChunks, kStreamingWorldChunks, kStreamingMemoryBudget);
+
+	StreamingResult result;
+	result.m_worldWidth = world.GetWorldWidth();
+	result.m_worldHeight = world.GetWorldHeight();
+
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned int step = 0; step < kStreamingSteps; ++step)
+	{
+		const int viewColumn = (int)(world.GetWorldWidth() / 2) + (int)step * kStreamingStepTiles;
+		const int viewRow = (int)(world.GetWorldHeight() / 2) + (int)step * kStreamingStepTiles / 2;
+		world.Update(viewColumn, viewRow, kMapWidth, kMapHeight);
+		while (!world.IsViewStreamed())
+		{
+			std::this_thread::yield();
+			world.Update(viewColumn, viewRow, kMapWidth, kMapHeight);
+		}
+
+		result.m_peakCachedBytes = std::max(result.m_peakCachedBytes, world.GetCachedBytes());
+	}
+	result.m_totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	result.m_generatedChunks = world.GetGeneratedChunkCount();
+	result.m_chunkSeconds = world.GetGenerationSeconds() / (double)std::max<size_t>(result.m_generatedChunks, 1);
+	return result;
+}
+
+/// <summary>
+/// ProgressiveWorldGenerator regenerating the window sized world: how long until the preview is up (the
+/// perceived latency), and until the full resolution world is. With one job thread the levels can't be
+/// refined in the background, and the preview takes as long as the final world.
+/// </summary>
+template <class NoiseBackend>
+static ProgressiveResult RunProgressiveBenchmark(unsigned int passes)
+{
+	using Generator = ProgressiveWorldGenerator<NoiseBackend>;
+
+	Generator generator(kSeed);
+	TileMap map(kMapWidth, kMapHeight, 1, 1);
+
+	ProgressiveResult result;
+	for (unsigned int pass = 0; pass < passes; ++pass)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		generator.Start(kMapWidth, kMapHeight);
+		result.m_startSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		while (!generator.IsFinished())
+		{
+			if (!generator.UpdateMap(map))
+				std::this_thread::yield();
+		}
+		result.m_finalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for (size_t level = 0; level < Generator::kNumLevels; ++level)
+			result.m_levelSeconds[level] += generator.GetLevelSeconds(level);
+	}
+
+	result.m_startSeconds /= (double)passes;
+	result.m_finalSeconds /= (double)passes;
+	for (double& levelSeconds : result.m_levelSeconds)
+		levelSeconds /= (double)passes;
+
+	return result;
+}
+
+static double GetMegapixels()
+{
+	return ((double)kMapWidth * (double)kMapHeight) / 1000000.0;
+}
+
+static void PrintNoiseResult(const NoiseResult& noise)
+{
+	std::printf("%-8s %-7s %7u %6u %10.2f %10.2f %10.2f %14.3f\n", noise.m_pBackend, noise.m_pPath,
+		noise.m_settings.m_octaves, noise.m_settings.m_inputRange, noise.m_result.m_bestSeconds * 1000.0,
+		GetMegapixels() / noise.m_result.m_bestSeconds, GetMegapixels() / noise.m_result.m_averageSeconds, noise.m_result.m_checksum);
+}
+
+static void PrintWorldResult(const WorldResult& world)
+{
+	const WorldGenerationTimings& average = world.m_averageTimings;
+	std::printf("%-8s %-5s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", world.m_pBackend, world.m_cullHeightOctaves ? "on" : "off",
+		world.m_bestSeconds * 1000.0, average.m_totalSeconds * 1000.0, average.m_noiseSeconds * 1000.0,
+		average.m_biomeSeconds * 1000.0, average.m_saltSeconds * 1000.0, average.m_growFloraSeconds * 1000.0);
+}
+
+static void PrintMoistureEditResult(const MoistureEditResult& edit, const Exelius::StagePipeline& pipeline)
+{
+	std::printf("Moisture edit: full %.2f ms, edit %.2f ms, reran", edit.m_fullSeconds * 1000.0, edit.m_editSeconds * 1000.0);
+	for (size_t stage = 0; stage < pipeline.GetStageCount(); ++stage)
+	{
+		if (edit.m_stageRan[stage])
+			std::printf(" %s", pipeline.GetStageName(stage));
+	}
+	std::printf("\n");
+}
+
+static void PrintStreamingResult(const StreamingResult& streaming)
+{
+	std::printf("%u x %u world, %zu chunks generated, %.2f ms per chunk, %.2f ms total, peak cache %.1f MB\n",
+		streaming.m_worldWidth, streaming.m_worldHeight, streaming.m_generatedChunks, streaming.m_chunkSeconds * 1000.0,
+		streaming.m_totalSeconds * 1000.0, (double)streaming.m_peakCachedBytes / (1024.0 * 1024.0));
+}
+
+static void PrintProgressiveResult(const ProgressiveResult& progressive)
+{
+	std::printf("Progressive: preview %.2f ms, final %.2f ms, levels", progressive.m_startSeconds * 1000.0, progressive.m_finalSeconds * 1000.0);
+	for (size_t level = 0; level < ProgressiveWorldGenerator<Exelius::PerlinNoise>::kNumLevels; ++level)
+	{
+		std::printf(" 1/%u %.2f ms", ProgressiveWorldGenerator<Exelius::PerlinNoise>::kLevelSteps[level], progressive.m_levelSeconds[level] * 1000.0);
+	}
+	std::printf("\n");
+}
+
+static void WriteNoiseJson(std::FILE* pFile, const std::vector<NoiseResult>& results)
+{
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const NoiseResult& noise = results[i];
+		std::fprintf(pFile, "    { \"backend\": \"%s\", \"path\": \"%s\", \"octaves\": %u, \"inputRange\": %u, "
+			"\"bestMs\": %.4f, \"bestMpixelsPerSecond\": %.4f, \"averageMpixelsPerSecond\": %.4f, \"checksum\": %.4f }%s\n",
+			noise.m_pBackend, noise.m_pPath, noise.m_settings.m_octaves, noise.m_settings.m_inputRange,
+			noise.m_result.m_bestSeconds * 1000.0, GetMegapixels() / noise.m_result.m_bestSeconds,
+			GetMegapixels() / noise.m_result.m_averageSeconds, noise.m_result.m_checksum, (i + 1 < results.size()) ? "," : "");
+	}
+}
+
+/// <summary>
+/// Writes every result as one JSON object, so builds can be compared by a script.
+/// </summary>
+static void WriteJson(std::FILE* pFile, unsigned int passes, const std::vector<NoiseResult>& backends,
+	const std::vector<NoiseResult>& sweep, const std::vector<WorldResult>& worlds, const MoistureEditResult& moistureEdit,
+	const Exelius::StagePipeline& pipeline, const StreamingResult& streaming, const ProgressiveResult& progressive)
+{
+	std::fprintf(pFile, "{\n");
+	std::fprintf(pFile, "  \"mapWidth\": %u,\n  \"mapHeight\": %u,\n  \"simdLanes\": %zu,\n  \"threads\": %u,\n  \"passes\": %u,\n  \"persistance\": %.2f,\n",
+		kMapWidth, kMapHeight, Exelius::Simd::kLaneCount, Exelius::JobSystem::GetInstance().GetThreadCount(), passes, kPersistance);
+
+	std::fprintf(pFile, "  \"backends\": [\n");
+	WriteNoiseJson(pFile, backends);
+	std::fprintf(pFile, "  ],\n");
+
+	std::fprintf(pFile, "  \"octaveSweep\": [\n");
+	WriteNoiseJson(pFile, sweep);
+	std::fprintf(pFile, "  ],\n");
+
+	std::fprintf(pFile, "  \"worldGeneration\": [\n");
+	for (size_t i = 0; i < worlds.size(); ++i)
+	{
+		const WorldResult& world = worlds[i];
+		const WorldGenerationTimings& average = world.m_averageTimings;
+		std::fprintf(pFile, "    { \"backend\": \"%s\", \"heightOctaveCulling\": %s, \"bestTotalMs\": %.4f, \"totalMs\": %.4f, "
+			"\"noiseMs\": %.4f, \"biomeMs\": %.4f, \"saltMs\": %.4f, \"growFloraMs\": %.4f }%s\n",
+			world.m_pBackend, world.m_cullHeightOctaves ? "true" : "false", world.m_bestSeconds * 1000.0, average.m_totalSeconds * 1000.0,
+			average.m_noiseSeconds * 1000.0, average.m_biomeSeconds * 1000.0, average.m_saltSeconds * 1000.0,
+			average.m_growFloraSeconds * 1000.0, (i + 1 < worlds.size()) ? "," : "");
+	}
+	std::fprintf(pFile, "  ],\n");
+
+	std::fprintf(pFile, "  \"moistureEdit\": { \"fullMs\": %.4f, \"editMs\": %.4f, \"rerunStages\": [",
+		moistureEdit.m_fullSeconds * 1000.0, moistureEdit.m_editSeconds * 1000.0);
+	const char* pSeparator = " ";
+	for (size_t stage = 0; stage < pipeline.GetStageCount(); ++stage)
+	{
+		if (!moistureEdit.m_stageRan[stage])
+			continue;
+
+		std::fprintf(pFile, "%s\"%s\"", pSeparator, pipeline.GetStageName(stage));
+		pSeparator = ", ";
+	}
+	std::fprintf(pFile, " ] },\n");
+
+	std::fprintf(pFile, "  \"chunkStreaming\": { \"worldWidth\": %u, \"worldHeight\": %u, \"generatedChunks\": %zu, "
+		"\"msPerChunk\": %.4f, \"totalMs\": %.4f, \"peakCacheBytes\": %zu },\n",
+		streaming.m_worldWidth, streaming.m_worldHeight, streaming.m_generatedChunks, streaming.m_chunkSeconds * 1000.0,
+		streaming.m_totalSeconds * 1000.0, streaming.m_peakCachedBytes);
+
+	std::fprintf(pFile, "  \"progressive\": { \"previewMs\": %.4f, \"finalMs\": %.4f, \"levelMs\": [",
+		progressive.m_startSeconds * 1000.0, progressive.m_finalSeconds * 1000.0);
+	for (size_t level = 0; level < ProgressiveWorldGenerator<Exelius::PerlinNoise>::kNumLevels; ++level)
+	{
+		std::fprintf(pFile, "%s%.4f", (level > 0) ? ", " : " ", progressive.m_levelSeconds[level] * 1000.0);
+	}
+	std::fprintf(pFile, " ] }\n}\n");
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int passes = kDefaultPasses;
+	const char* pJsonPath = nullptr;
+
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		if (std::strcmp(argv[arg], "--json") == 0)
+			pJsonPath = (arg + 1 < argc) ? argv[++arg] : "-";
+		else
+			passes = (unsigned int)std::strtoul(argv[arg], nullptr, 10);
+	}
+	if (passes == 0)
+		passes = 1;
+
+	const NoiseSettings defaultSettings = { kDefaultOctaves, kDefaultInputRange };
+
+	std::printf("%u x %u map, persistance %.2f, %zu SIMD lanes, %u job threads, %u passes\n\n",
+		kMapWidth, kMapHeight, kPersistance, Exelius::Simd::kLaneCount, Exelius::JobSystem::GetInstance().GetThreadCount(), passes);
+
+	// Backends and call paths at the default height map settings.
+	std::vector<NoiseResult> backends;
+	backends.push_back({ "Perlin", "Scalar", defaultSettings, RunScalarBenchmark<Exelius::PerlinNoise>(passes, defaultSettings) });
+	backends.push_back({ "Perlin", "Row", defaultSettings, RunRowBenchmark<Exelius::PerlinNoise>(passes, defaultSettings) });
+	backends.push_back({ "Simplex", "Scalar", defaultSettings, RunScalarBenchmark<Exelius::SimplexNoise>(passes, defaultSettings) });
+	backends.push_back({ "Simplex", "Row", defaultSettings, RunRowBenchmark<Exelius::SimplexNoise>(passes, defaultSettings) });
+
+	std::printf("%-8s %-7s %7s %6s %10s %10s %10s %14s\n", "Backend", "Path", "Octaves", "Range", "Best ms", "Best MP/s", "Avg MP/s", "Checksum");
+	for (const NoiseResult& noise : backends)
+		PrintNoiseResult(noise);
+
+	// GetAverageNoise cost against octave count and input range. The row path is what the generators run.
+	std::vector<NoiseResult> sweep;
+	std::printf("\n");
+	for (unsigned int octaves : kSweepOctaves)
+	{
+		for (unsigned int inputRange : kSweepInputRanges)
+		{
+			const NoiseSettings settings = { octaves, inputRange };
+			sweep.push_back({ "Perlin", "Row", settings, RunRowBenchmark<Exelius::PerlinNoise>(passes, settings) });
+			PrintNoiseResult(sweep.back());
+		}
+	}
+
+	// Where GenerateWorld spends its time, in wall clock per pipeline stage.
+	std::vector<WorldResult> worlds;
+	worlds.push_back(RunWorldBenchmark<Exelius::PerlinNoise>(passes, "Perlin", false));
+	worlds.push_back(RunWorldBenchmark<Exelius::PerlinNoise>(passes, "Perlin", true));
+	worlds.push_back(RunWorldBenchmark<Exelius::SimplexNoise>(passes, "Simplex", false));
+
+	std::printf("\n%-8s %-5s %10s %10s %10s %10s %10s %10s\n", "Backend", "Cull", "Best ms", "Avg ms", "Noise ms", "Biome ms", "Salt ms", "Flora ms");
+	for (const WorldResult& world : worlds)
+		PrintWorldResult(world);
+
+	// Regenerating after a moisture change, from the cached height and tempurature planes.
+	const WorldGenerator<Exelius::PerlinNoise> stageNames;
+	const MoistureEditResult moistureEdit = RunMoistureEditBenchmark<Exelius::PerlinNoise>(passes);
+	std::printf("\n");
+	PrintMoistureEditResult(moistureEdit, stageNames.GetPipeline());
+
+	// Chunks generated on demand around a moving view.
+	const StreamingResult streaming = RunStreamingBenchmark<Exelius::PerlinNoise>();
+	std::printf("\n");
+	PrintStreamingResult(streaming);
+
+	// Coarse to fine regeneration, as GeneratorView does it.
+	const ProgressiveResult progressive = RunProgressiveBenchmark<Exelius::PerlinNoise>(passes);
+	PrintProgressiveResult(progressive);
+
+	if (pJsonPath)
+	{
+		const bool toStdout = (std::strcmp(pJsonPath, "-") == 0);
+		std::FILE* pFile = toStdout ? stdout : std::fopen(pJsonPath, "w");
+		if (!pFile)
+		{
+			std::fprintf(stderr, "Could not open %s for writing.\n", pJsonPath);
+			return 1;
+		}
+
+		if (toStdout)
+			std::printf("\n");
+		WriteJson(pFile, passes, backends, sweep, worlds, moistureEdit, stageNames.GetPipeline(), streaming, progressive);
+
+		if (!toStdout)
+			std::fclose(pFile);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "ImageFile.h"
+
+#include <array>
+#include <cstdio>
+
+// Deflate length codes 257 - 285: the smallest length of each, and the extra bits after it.
+static constexpr unsigned int kLengthBases[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static constexpr unsigned int kLengthExtraBits[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static constexpr size_t kNumLengthCodes = sizeof(kLengthBases) / sizeof(kLengthBases[0]);
+
+static constexpr unsigned int kMinMatchLength = 3;
+static constexpr unsigned int kMaxMatchLength = 258;
+
+// Matches only ever go back one RGB pixel. Distance 3 is fixed distance code 2, without extra bits.
+static constexpr size_t kMatchDistance = 3;
+static constexpr unsigned int kMatchDistanceCode = 2;
+
+static constexpr unsigned int kEndOfBlock = 256;
+
+/// <summary>
+/// Deflate bit stream. Values go in least significant bit first, Huffman codes most significant bit first.
+/// </summary>
+class DeflateWriter
+{
+	std::vector<uint8_t>& m_out;
+	uint32_t m_bitBuffer;
+	unsigned int m_numBits;
+
+public:
+	explicit DeflateWriter(std::vector<uint8_t>& out)
+		: m_out(out)
+		, m_bitBuffer(0)
+		, m_numBits(0)
+	{
+		//
+	}
+
+	void WriteBits(uint32_t value, unsigned int numBits)
+	{
+		m_bitBuffer |= value << m_numBits;
+		m_numBits += numBits;
+		while (m_numBits >= 8)
+		{
+			m_out.push_back((uint8_t)m_bitBuffer);
+			m_bitBuffer >>= 8;
+			m_numBits -= 8;
+		}
+	}
+
+	void WriteCode(uint32_t code, unsigned int numBits)
+	{
+		uint32_t reversed = 0;
+		for (unsigned int bit = 0; bit < numBits; ++bit)
+		{
+			reversed = (reversed << 1) | ((code >> bit) & 1);
+		}
+		WriteBits(reversed, numBits);
+	}
+
+	/// <summary>
+	/// A literal/length symbol with the fixed Huffman codes of RFC 1951 3.2.6.
+	/// </summary>
+	void WriteSymbol(unsigned int symbol)
+	{
+		if (symbol <= 143)
+			WriteCode(0x30 + symbol, 8);
+		else if (symbol <= 255)
+			WriteCode(0x190 + symbol - 144, 9);
+		else if (symbol <= 279)
+			WriteCode(symbol - 256, 7);
+		else
+			WriteCode(0xC0 + symbol - 280, 8);
+	}
+
+	void WriteMatch(unsigned int length)
+	{
+		size_t code = kNumLengthCodes - 1;
+		while (kLengthBases[code] > length)
+			--code;
+
+		WriteSymbol(257 + (unsigned int)code);
+		WriteBits(length - kLengthBases[code], kLengthExtraBits[code]);
+		WriteCode(kMatchDistanceCode, 5);
+	}
+
+	void Flush()
+	{
+		if (m_numBits > 0)
+			WriteBits(0, 8 - m_numBits);
+	}
+};
+
+static uint32_t GetCrc32(const uint8_t* pBytes, size_t numBytes, uint32_t crc = 0)
+{
+	static const std::array<uint32_t, 256> s_table = []()
+	{
+		std::array<uint32_t, 256> table = {};
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			uint32_t value = i;
+			for (int bit = 0; bit < 8; ++bit)
+				value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+			table[i] = value;
+		}
+		return table;
+	}();
+
+	crc = ~crc;
+	for (size_t i = 0; i < numBytes; ++i)
+	{
+		crc = s_table[(crc ^ pBytes[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return ~crc;
+}
+
+static uint32_t GetAdler32(const std::vector<uint8_t>& bytes)
+{
+	constexpr uint32_t kModulus = 65521;
+
+	uint32_t a = 1;
+	uint32_t b = 0;
+	for (uint8_t byte : bytes)
+	{
+		a = (a + byte) % kModulus;
+		b = (b + a) % kModulus;
+	}
+	return (b << 16) | a;
+}
+
+static void AppendBigEndian(std::vector<uint8_t>& out, uint32_t value)
+{
+	out.push_back((uint8_t)(value >> 24));
+	out.push_back((uint8_t)(value >> 16));
+	out.push_back((uint8_t)(value >> 8));
+	out.push_back((uint8_t)value);
+}
+
+static void AppendPngChunk(std::vector<uint8_t>& out, const char* pType, const std::vector<uint8_t>& data)
+{
+	AppendBigEndian(out, (uint32_t)data.size());
+
+	const size_t typeStart = out.size();
+	out.insert(out.end(), pType, pType + 4);
+	out.insert(out.end(), data.begin(), data.end());
+
+	AppendBigEndian(out, GetCrc32(out.data() + typeStart, out.size() - typeStart));
+}
+
+/// <summary>
+/// A zlib stream (RFC 1950) of one fixed Huffman deflate block.
+/// </summary>
+static std::vector<uint8_t> Compress(const std::vector<uint8_t>& bytes)
+{
+	std::vector<uint8_t> out = { 0x78, 0x01 };
+
+	DeflateWriter writer(out);
+	writer.WriteBits(1, 1);	// Last block.
+	writer.WriteBits(1, 2);	// Fixed Huffman codes.
+
+	size_t i = 0;
+	while (i < bytes.size())
+	{
+		unsigned int length = 0;
+		if (i >= kMatchDistance)
+		{
+			while (length < kMaxMatchLength && i + length < bytes.size() && bytes[i + length] == bytes[i + length - kMatchDistance])
+				++length;
+		}
+
+		if (length >= kMinMatchLength)
+		{
+			writer.WriteMatch(length);
+			i += length;
+		}
+		else
+		{
+			writer.WriteSymbol(bytes[i]);
+			++i;
+		}
+	}
+
+	writer.WriteSymbol(kEndOfBlock);
+	writer.Flush();
+
+	AppendBigEndian(out, GetAdler32(bytes));
+	return out;
+}
+
+static bool WriteFile(const char* pPath, const void* pBytes, size_t numBytes)
+{
+	std::FILE* pFile = std::fopen(pPath, "wb");
+	if (!pFile)
+		return false;
+
+	const bool wroteAll = std::fwrite(pBytes, 1, numBytes, pFile) == numBytes;
+	return (std::fclose(pFile) == 0) && wroteAll;
+}
+
+/// <summary>
+/// The pixels as RGB bytes, with rowPrefix bytes of 0 before every row (PNG's filter type).
+/// </summary>
+static std::vector<uint8_t> GetRgbRows(const std::vector<uint32_t>& colors, unsigned int width, unsigned int height, size_t rowPrefix)
+{
+	std::vector<uint8_t> bytes;
+	bytes.reserve((size_t)height * (rowPrefix + (size_t)width * 3));
+
+	for (unsigned int row = 0; row < height; ++row)
+	{
+		bytes.insert(bytes.end(), rowPrefix, 0);
+
+		const uint32_t* pRow = colors.data() + (size_t)row * width;
+		for (unsigned int column = 0; column < width; ++column)
+		{
+			bytes.push_back((uint8_t)(pRow[column] >> 24));
+			bytes.push_back((uint8_t)(pRow[column] >> 16));
+			bytes.push_back((uint8_t)(pRow[column] >> 8));
+		}
+	}
+	return bytes;
+}
+
+const char* GetImageExtension(ImageFormat format)
+{
+	switch (format)
+	{
+	case ImageFormat::kPpm: return "ppm";
+	case ImageFormat::kPng: return "png";
+	default: return "raw";
+	}
+}
+
+bool WritePpm(const char* pPath, const std::vector<uint32_t>& colors, unsigned int width, unsigned int height)
+{
+	char header[64];
+	const int headerLength = std::snprintf(header, sizeof(header), "P6\n%u %u\n255\n", width, height);
+
+	std::vector<uint8_t> bytes(header, header + headerLength);
+	const std::vector<uint8_t> pixels = GetRgbRows(colors, width, height, 0);
+	bytes.insert(bytes.end(), pixels.begin(), pixels.end());
+
+	return WriteFile(pPath, bytes.data(), bytes.size());
+}
+
+bool WritePng(const char* pPath, const std::vector<uint32_t>& colors, unsigned int width, unsigned int height)
+{
+	static constexpr uint8_t kSignature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	std::vector<uint8_t> bytes(kSignature, kSignature + sizeof(kSignature));
+
+	// 8 bit RGB, deflate, adaptive filtering (every row uses filter 0), no interlace.
+	std::vector<uint8_t> header;
+	AppendBigEndian(header, width);
+	AppendBigEndian(header, height);
+	header.insert(header.end(), { 8, 2, 0, 0, 0 });
+	AppendPngChunk(bytes, "IHDR", header);
+
+	AppendPngChunk(bytes, "IDAT", Compress(GetRgbRows(colors, width, height, 1)));
+	AppendPngChunk(bytes, "IEND", {});
+
+	return WriteFile(pPath, bytes.data(), bytes.size());
+}
+
+bool WriteRaw(const char* pPath, const void* pBytes, size_t numBytes)
+{
+	return WriteFile(pPath, pBytes, numBytes);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Formats WorldBaker writes a world in.
+///		Raw: the BiomeId plane, one byte per tile, rows top to bottom. No header, the size is in the name.
+///		Ppm: binary PPM (P6), the biome colors. Readable by most tools, but large.
+///		Png: 8 bit RGB PNG, the biome colors.
+/// </summary>
+enum class ImageFormat
+{
+	kRaw,
+	kPpm,
+	kPng
+};
+
+/// <summary>
+/// File extension of a format, without the dot.
+/// </summary>
+const char* GetImageExtension(ImageFormat format);
+
+/// <summary>
+/// Write width x height pixels of packed 0xRRGGBBAA colors (TileMap's color plane) as a PPM. Alpha is dropped.
+/// </summary>
+/// <returns>(bool) False if the file could not be written.</returns>
+bool WritePpm(const char* pPath, const std::vector<uint32_t>& colors, unsigned int width, unsigned int height);
+
+/// <summary>
+/// Write width x height pixels of packed 0xRRGGBBAA colors as an RGB PNG. Alpha is dropped.
+///
+/// Biome maps are long runs of the same color, so the image is deflated with only the fixed Huffman codes
+/// and one match distance, the previous pixel. A window sized map comes out about 20 times smaller than
+/// the PPM, without a dependency on zlib (which would get it another 3 times smaller).
+/// </summary>
+/// <returns>(bool) False if the file could not be written.</returns>
+bool WritePng(const char* pPath, const std::vector<uint32_t>& colors, unsigned int width, unsigned int height);
+
+/// <summary>
+/// Write bytes as they are.
+/// </summary>
+/// <returns>(bool) False if the file could not be written.</returns>
+bool WriteRaw(const char* pPath, const void* pBytes, size_t numBytes);
\ No newline at end of file
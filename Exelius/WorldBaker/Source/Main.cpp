@@ -0,0 +1,375 @@
+#include "ImageFile.h"
+
+#include <Utilities/JobSystem.h>
+#include <Utilities/TraceRecorder.h>
+#include <Utilities/Random/Noise/PerlinNoise.h>
+#include <Utilities/Random/Noise/SimplexNoise.h>
+#include <World/TileMap/TileMap.h>
+#include <World/WorldGeneration/WorldGenerator.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Headless world baker. Generates a batch of worlds, one per seed, and writes them out along with how long
+// every generation stage took. For pre-baking worlds on build servers and for performance runs in CI.
+//
+// Usage: WorldBaker [--seeds <n>] [--first-seed <seed>] [--size <width>x<height>] [--format raw|ppm|png|none]
+//		[--backend perlin|simplex] [--out <directory>] [--threads <n>] [--json <file>]
+//		[--trace <file>] [--planes]
+//		--seeds			Number of worlds (default 1). Seeds count up from the first seed.
+//		--first-seed	Seed of the first world (default 1).
+//		--size			World size in tiles (default 1280x720, the window sized map).
+//		--format		Output format (default png). raw is the BiomeId plane, none only times the generation.
+//		--backend		Noise backend (default perlin).
+//		--out			Directory the worlds are written to, created if it doesn't exist (default .).
+//		--threads		Job system threads (default one per hardware thread).
+//		--json			Also write the timings as JSON to <file>, or to stdout when <file> is "-".
+//		--trace			Record a trace of every stage on every thread to <file>, for about:tracing or ui.perfetto.dev.
+//		--planes		Also write the Height, Tempurature and Moisture planes the biomes were classified from, as raw
+//						floats, to <out>/world_<seed>_<width>x<height>_<plane>.raw.
+//
+// Worlds are generated in parallel, one job per seed, and every world's stages split their rows over the
+// same job system. A world is written to <out>/world_<seed>_<width>x<height>.<format>.
+
+using StageSeconds = double[WorldGenerator<Exelius::PerlinNoise>::kNumPipelineStages];
+
+struct BakeSettings
+{
+	unsigned int m_numSeeds = 1;
+	unsigned long long m_firstSeed = 1;
+	unsigned int m_worldWidth = 1280;
+	unsigned int m_worldHeight = 720;
+	bool m_writeFiles = true;
+	ImageFormat m_format = ImageFormat::kPng;
+	bool m_simplex = false;
+	std::string m_outDirectory = ".";
+	std::string m_tracePath;
+	bool m_writePlanes = false;
+};
+
+struct BakeResult
+{
+	unsigned long long m_seed = 0;
+	StageSeconds m_stageSeconds = {};
+	double m_generateSeconds = 0.0;
+	double m_writeSeconds = 0.0;
+
+	// Tiles that aren't ocean. A map that is all ocean is almost certainly a broken generator.
+	size_t m_landTiles = 0;
+
+	std::string m_path;
+	bool m_wroteFile = false;
+	bool m_wrotePlanes = true;
+};
+
+/// <summary>
+/// Write one of a map's planes as raw values, next to the world file.
+/// </summary>
+template <TilePlane kPlane>
+static bool WritePlane(const TileMap& map, const std::string& pathStem)
+{
+	const std::vector<TileMap::PlaneValue<kPlane>>& values = map.GetPlane<kPlane>();
+	const std::string path = pathStem + "_" + TilePlaneTraits<kPlane>::kName + ".raw";
+	return WriteRaw(path.c_str(), values.data(), values.size() * sizeof(values[0]));
+}
+
+template <class NoiseBackend>
+static BakeResult BakeWorld(const BakeSettings& settings, unsigned long long seed)
+{
+	BakeResult result;
+	result.m_seed = seed;
+
+	TileMap map(settings.m_worldWidth, settings.m_worldHeight, 1, 1);
+	if (settings.m_writePlanes)
+	{
+		map.AddPlane<TilePlane::kHeight>();
+		map.AddPlane<TilePlane::kTempurature>();
+		map.AddPlane<TilePlane::kMoisture>();
+	}
+
+	WorldGenerator<NoiseBackend> generator(seed);
+	generator.GenerateWorld(map);
+
+	const Exelius::StagePipeline& pipeline = generator.GetPipeline();
+	for (size_t stage = 0; stage < pipeline.GetStageCount(); ++stage)
+		result.m_stageSeconds[stage] = pipeline.GetStageSeconds(stage);
+	result.m_generateSeconds = generator.GetLastTimings().m_totalSeconds;
+
+	for (BiomeId biome : map.GetBiomes())
+		result.m_landTiles += (biome != BiomeId::kOcean) ? 1 : 0;
+
+	if (!settings.m_writeFiles)
+		return result;
+
+	EXELIUS_TRACE_SCOPE("Write world");
+	const auto writeStart = std::chrono::steady_clock::now();
+
+	const std::string fileStem = "world_" + std::to_string(seed) + "_" + std::to_string(settings.m_worldWidth) + "x"
+		+ std::to_string(settings.m_worldHeight);
+	const std::string pathStem = (std::filesystem::path(settings.m_outDirectory) / fileStem).string();
+	result.m_path = pathStem + "." + GetImageExtension(settings.m_format);
+
+	if (settings.m_format == ImageFormat::kRaw)
+	{
+		const std::vector<BiomeId>& biomes = map.GetBiomes();
+		result.m_wroteFile = WriteRaw(result.m_path.c_str(), biomes.data(), biomes.size() * sizeof(BiomeId));
+	}
+	else
+	{
+		map.ApplyBiomePalette();
+		if (settings.m_format == ImageFormat::kPpm)
+			result.m_wroteFile = WritePpm(result.m_path.c_str(), map.GetTiles(), settings.m_worldWidth, settings.m_worldHeight);
+		else
+			result.m_wroteFile = WritePng(result.m_path.c_str(), map.GetTiles(), settings.m_worldWidth, settings.m_worldHeight);
+	}
+
+	if (settings.m_writePlanes)
+	{
+		result.m_wrotePlanes = WritePlane<TilePlane::kHeight>(map, pathStem)
+			&& WritePlane<TilePlane::kTempurature>(map, pathStem)
+			&& WritePlane<TilePlane::kMoisture>(map, pathStem);
+	}
+
+	result.m_writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - writeStart).count();
+	return result;
+}
+
+static void PrintResults(const BakeSettings& settings, const std::vector<BakeResult>& results, const Exelius::StagePipeline& pipeline, double wallSeconds)
+{
+	std::printf("%-12s %7s", "Seed", "Land %");
+	for (size_t stage = 0; stage < pipeline.GetStageCount(); ++stage)
+	{
+		const std::string column = std::string(pipeline.GetStageName(stage)) + " ms";
+		std::printf(" %15s", column.c_str());
+	}
+	std::printf(" %10s %10s\n", "Total ms", "Write ms");
+
+	for (const BakeResult& result : results)
+	{
+		const double tileCount = (double)settings.m_worldWidth * (double)settings.m_worldHeight;
+		std::printf("%-12llu %7.2f", result.m_seed, (double)result.m_landTiles * 100.0 / tileCount);
+		for (size_t stage = 0; stage < pipeline.GetStageCount(); ++stage)
+			std::printf(" %15.2f", result.m_stageSeconds[stage] * 1000.0);
+		std::printf(" %10.2f %10.2f\n", result.m_generateSeconds * 1000.0, result.m_writeSeconds * 1000.0);
+	}
+
+	std::printf("\n%zu worlds in %.2f ms, %.2f worlds per second\n", results.size(), wallSeconds * 1000.0, (double)results.size() / wallSeconds);
+}
+
+/// <summary>
+/// Writes the settings and every world's timings as one JSON object, so runs can be compared by a script.
+/// </summary>
+static void WriteJson(std::FILE* pFile, const BakeSettings& settings, const std::vector<BakeResult>& results,
+	const Exelius::StagePipeline& pipeline, double wallSeconds)
+{
+	std::fprintf(pFile, "{\n");
+	std::fprintf(pFile, "  \"worldWidth\": %u,\n  \"worldHeight\": %u,\n  \"backend\": \"%s\",\n  \"threads\": %u,\n  \"wallMs\": %.4f,\n",
+		settings.m_worldWidth, settings.m_worldHeight, settings.m_simplex ? "simplex" : "perlin",
+		Exelius::JobSystem::GetInstance().GetThreadCount(), wallSeconds * 1000.0);
+
+	std::fprintf(pFile, "  \"worlds\": [\n");
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const BakeResult& result = results[i];
+		std::fprintf(pFile, "    { \"seed\": %llu, \"landTiles\": %zu, \"stageMs\": {", result.m_seed, result.m_landTiles);
+		for (size_t stage = 0; stage < pipeline.GetStageCount(); ++stage)
+		{
+			std::fprintf(pFile, "%s\"%s\": %.4f", (stage > 0) ? ", " : " ", pipeline.GetStageName(stage), result.m_stageSeconds[stage] * 1000.0);
+		}
+		std::fprintf(pFile, " }, \"totalMs\": %.4f, \"writeMs\": %.4f, \"file\": \"%s\" }%s\n",
+			result.m_generateSeconds * 1000.0, result.m_writeSeconds * 1000.0, result.m_path.c_str(), (i + 1 < results.size()) ? "," : "");
+	}
+	std::fprintf(pFile, "  ]\n}\n");
+}
+
+static bool ParseArguments(int argc, char* argv[], BakeSettings& settings, unsigned int& numThreads, const char*& pJsonPath)
+{
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		const char* pValue = (arg + 1 < argc) ? argv[arg + 1] : nullptr;
+
+		if (std::strcmp(argv[arg], "--json") == 0)
+		{
+			pJsonPath = pValue ? pValue : "-";
+		}
+		else if (std::strcmp(argv[arg], "--planes") == 0)
+		{
+			settings.m_writePlanes = true;
+			continue;
+		}
+		else if (!pValue)
+		{
+			std::fprintf(stderr, "Missing value for %s.\n", argv[arg]);
+			return false;
+		}
+		else if (std::strcmp(argv[arg], "--seeds") == 0)
+		{
+			settings.m_numSeeds = (unsigned int)std::strtoul(pValue, nullptr, 10);
+		}
+		else if (std::strcmp(argv[arg], "--first-seed") == 0)
+		{
+			settings.m_firstSeed = std::strtoull(pValue, nullptr, 10);
+		}
+		else if (std::strcmp(argv[arg], "--size") == 0)
+		{
+			if (std::sscanf(pValue, "%ux%u", &settings.m_worldWidth, &settings.m_worldHeight) != 2 || settings.m_worldWidth == 0 || settings.m_worldHeight == 0)
+			{
+				std::fprintf(stderr, "Invalid size %s, expected <width>x<height>.\n", pValue);
+				return false;
+			}
+		}
+		else if (std::strcmp(argv[arg], "--format") == 0)
+		{
+			settings.m_writeFiles = true;
+			if (std::strcmp(pValue, "raw") == 0)
+				settings.m_format = ImageFormat::kRaw;
+			else if (std::strcmp(pValue, "ppm") == 0)
+				settings.m_format = ImageFormat::kPpm;
+			else if (std::strcmp(pValue, "png") == 0)
+				settings.m_format = ImageFormat::kPng;
+			else if (std::strcmp(pValue, "none") == 0)
+				settings.m_writeFiles = false;
+			else
+			{
+				std::fprintf(stderr, "Unknown format %s.\n", pValue);
+				return false;
+			}
+		}
+		else if (std::strcmp(argv[arg], "--backend") == 0)
+		{
+			if (std::strcmp(pValue, "perlin") != 0 && std::strcmp(pValue, "simplex") != 0)
+			{
+				std::fprintf(stderr, "Unknown backend %s.\n", pValue);
+				return false;
+			}
+			settings.m_simplex = (std::strcmp(pValue, "simplex") == 0);
+		}
+		else if (std::strcmp(argv[arg], "--out") == 0)
+		{
+			settings.m_outDirectory = pValue;
+		}
+		else if (std::strcmp(argv[arg], "--threads") == 0)
+		{
+			numThreads = (unsigned int)std::strtoul(pValue, nullptr, 10);
+		}
+		else if (std::strcmp(argv[arg], "--trace") == 0)
+		{
+			settings.m_tracePath = pValue;
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown argument %s.\n", argv[arg]);
+			return false;
+		}
+
+		++arg;
+	}
+
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	BakeSettings settings;
+	unsigned int numThreads = 0;
+	const char* pJsonPath = nullptr;
+
+	if (!ParseArguments(argc, argv, settings, numThreads, pJsonPath))
+		return 1;
+
+	if (numThreads > 0)
+		Exelius::JobSystem::Initialize(numThreads);
+	Exelius::JobSystem& jobSystem = Exelius::JobSystem::GetInstance();
+
+	if (settings.m_writeFiles)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(settings.m_outDirectory, error);
+		if (error)
+		{
+			std::fprintf(stderr, "Could not create %s: %s\n", settings.m_outDirectory.c_str(), error.message().c_str());
+			return 1;
+		}
+	}
+
+	std::printf("%u worlds of %u x %u, %s, %u job threads\n\n", settings.m_numSeeds, settings.m_worldWidth, settings.m_worldHeight,
+		settings.m_simplex ? "Simplex" : "Perlin", jobSystem.GetThreadCount());
+
+	Exelius::TraceRecorder& traceRecorder = Exelius::TraceRecorder::GetInstance();
+	if (!settings.m_tracePath.empty())
+	{
+		traceRecorder.SetCurrentThreadName("Main");
+		traceRecorder.SetEnabled(true);
+	}
+
+	// One job per world. A thread waiting on a world's stage picks up other worlds meanwhile.
+	std::vector<BakeResult> results(settings.m_numSeeds);
+	const auto start = std::chrono::steady_clock::now();
+	jobSystem.ParallelFor(0, settings.m_numSeeds, 1, [&settings, &results](size_t first, size_t end)
+	{
+		for (size_t i = first; i < end; ++i)
+		{
+			const unsigned long long seed = settings.m_firstSeed + i;
+			results[i] = settings.m_simplex ? BakeWorld<Exelius::SimplexNoise>(settings, seed) : BakeWorld<Exelius::PerlinNoise>(settings, seed);
+		}
+	});
+	const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	traceRecorder.SetEnabled(false);
+
+	// Only for the stage names, which are the same for every backend.
+	const WorldGenerator<Exelius::PerlinNoise> stageNames;
+	PrintResults(settings, results, stageNames.GetPipeline(), wallSeconds);
+
+	int exitCode = 0;
+	for (const BakeResult& result : results)
+	{
+		if (settings.m_writeFiles && !result.m_wroteFile)
+		{
+			std::fprintf(stderr, "Could not write %s.\n", result.m_path.c_str());
+			exitCode = 1;
+		}
+		if (settings.m_writeFiles && !result.m_wrotePlanes)
+		{
+			std::fprintf(stderr, "Could not write the planes of world %llu.\n", result.m_seed);
+			exitCode = 1;
+		}
+	}
+
+	if (!settings.m_tracePath.empty())
+	{
+		if (traceRecorder.WriteChromeTrace(settings.m_tracePath.c_str()))
+		{
+			std::printf("Wrote %zu trace events to %s\n", traceRecorder.GetEventCount(), settings.m_tracePath.c_str());
+		}
+		else
+		{
+			std::fprintf(stderr, "Could not write %s.\n", settings.m_tracePath.c_str());
+			exitCode = 1;
+		}
+	}
+
+	if (pJsonPath)
+	{
+		const bool toStdout = (std::strcmp(pJsonPath, "-") == 0);
+		std::FILE* pFile = toStdout ? stdout : std::fopen(pJsonPath, "w");
+		if (!pFile)
+		{
+			std::fprintf(stderr, "Could not open %s for writing.\n", pJsonPath);
+			return 1;
+		}
+
+		if (toStdout)
+			std::printf("\n");
+		WriteJson(pFile, settings, results, stageNames.GetPipeline(), wallSeconds);
+
+		if (!toStdout)
+			std::fclose(pFile);
+	}
+
+	return exitCode;
+}
\ No newline at end of file
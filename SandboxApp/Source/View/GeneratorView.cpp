@@ -4,6 +4,9 @@
 #include <ApplicationLayer.h>
 #include <Managers/Input.h>
 #include <Components/TransformComponent.h>
+#include <Utilities/TraceRecorder.h>
+
+#include <algorithm>
 
 // Temporary solution to
 // broken Engine Log.
@@ -16,12 +19,23 @@ GeneratorView::GeneratorView(std::shared_ptr<Exelius::Actor> pActor)
 	, m_cloudGenerator()
 	, m_fireGenerator()
 	, m_worldMap(kWorldWidth, kWorldHeight)
+	, m_exploreWorld(kExploreSeed, kExploreWorldChunks, kExploreWorldChunks)
+	, m_isExploring(false)
+	, m_cameraPosition({ 0.0f, 0.0f })
 	, m_pPlayerTransform(nullptr)
 	, m_pPlayerTexture(nullptr)
 	, m_playerMovement({ 0.0f, -1.0f })
 	, m_waterTankFull(false)
 	, m_pUIText(nullptr)
 {
+	// The biomes the player checks under itself on every key press.
+	m_worldMap.TrackBiomeCounts(BiomeId::kOcean);
+	m_worldMap.TrackBiomeCounts(BiomeId::kFire);
+
+	// The climate 'I' reports. The generator only keeps these planes for a map that has them.
+	m_worldMap.AddPlane<TilePlane::kHeight>();
+	m_worldMap.AddPlane<TilePlane::kTempurature>();
+	m_worldMap.AddPlane<TilePlane::kMoisture>();
 }
 
 bool GeneratorView::Initialize()
@@ -38,9 +52,10 @@ bool GeneratorView::Initialize()
 	m_pUIText = m_pUI->GetComponent<Exelius::TextRenderComponent>();
 
 	PrintInstructions();
-	m_worldGenerator.GenerateWorld(m_worldMap);
+
 	m_cloudGenerator.GenerateClouds();
-	m_fireGenerator.StartFire(m_worldMap);
+	m_worldGenerator.Start(kWorldWidth, kWorldHeight, true);
+	UpdateWorldMap();
 	return true;
 }
 
@@ -49,7 +64,16 @@ void GeneratorView::UpdateInput(float deltaTime)
 	if (deltaTime > 0.0333333f)
 		deltaTime = 0.033333f;
 
-	float fireRatio = m_fireGenerator.GetBurnPercentage() * 100.0f;
+	const bool isWorldFinal = UpdateWorldMap();
+
+	if (m_isExploring)
+	{
+		UpdateExploring(deltaTime);
+		return;
+	}
+
+	// Nothing burns before the fire has started.
+	float fireRatio = isWorldFinal ? m_fireGenerator.GetBurnPercentage() * 100.0f : 0.0f;
 	if (m_waterTankFull)
 	{
 		m_pUIText->ChangeText(("Water Tank is Full! \t" + std::to_string((int)fireRatio) + "% of land Destroyed!").c_str(), 255, 0, 0);
@@ -75,6 +99,22 @@ void GeneratorView::UpdateInput(float deltaTime)
 		return;
 	}
 
+	else if (pKeyboard->IsKeyPressed(Exelius::GenericKeyboard::Code::kCodeT))
+	{
+		ToggleTracing();
+	}
+
+	else if (pKeyboard->IsKeyPressed(Exelius::GenericKeyboard::Code::kCodeI))
+	{
+		PrintClimateUnderPlayer();
+	}
+
+	else if (pKeyboard->IsKeyPressed(Exelius::GenericKeyboard::Code::kCodeE))
+	{
+		ToggleExploring();
+		return;
+	}
+
 	else if (pKeyboard->IsKeyPressed(Exelius::GenericKeyboard::Code::kCodeSpace))
 	{
 		bool wasTankFull = m_waterTankFull;
@@ -102,7 +142,7 @@ void GeneratorView::UpdateInput(float deltaTime)
 	SetMovementVector();
 	
 	float faceDirection = 0.0f;
-	faceDirection = ((std::atan2f(m_playerMovement.y, m_playerMovement.x) * 180.0f) / Exelius::PI) + 90.0f;
+	faceDirection = ((std::atan2(m_playerMovement.y, m_playerMovement.x) * 180.0f) / Exelius::PI) + 90.0f;
 	m_pPlayerTexture->SetAngle(faceDirection);
 
 	float playerSpeed = 100.0f;
@@ -111,7 +151,7 @@ void GeneratorView::UpdateInput(float deltaTime)
 	ForcePlayerBounds();
 
 	m_cloudGenerator.UpdateClouds(deltaTime);
-	bool gameOver = m_fireGenerator.PropagateFire(deltaTime);
+	bool gameOver = isWorldFinal && m_fireGenerator.PropagateFire(deltaTime);
 
 	if (gameOver)
 	{
@@ -127,7 +167,10 @@ void GeneratorView::ViewScene()
 
 	// These should become actors and added to the list.
 	// Technically, this code could live in the engine entirely.
-	m_worldMap.RenderMap();
+	if (m_isExploring)
+		m_exploreWorld.Render((int)m_cameraPosition.x, (int)m_cameraPosition.y);
+	else
+		m_worldMap.RenderMap();
 
 	auto* pGameLayer = Exelius::IApplicationLayer::GetInstance()->GetGameLayer();
 	for (auto& actorPair : pGameLayer->GetActors())
@@ -144,12 +187,85 @@ void GeneratorView::PrintInstructions()
 {
 	std::cout << "Press 'Esc' to regenerate the world.\n\n";
 	std::cout << "Press 'Q' to close the application.\n\n";
+	std::cout << "Press 'T' to start tracing, and again to write the trace to " << kTracePath << ".\n\n";
+	std::cout << "Press 'I' to show the climate under the player.\n\n";
+	std::cout << "Press 'E' to explore a world " << kExploreWorldChunks << " chunks across, and again to go back.\n\n";
 	std::cout << "Press Arrow Keys to change direction.\n\n";
 	std::cout << "Press 'Space' while over water to fill up the water tank.\n\n";
 	std::cout << "Press 'Space' while over fire to extinguish it.\n\n";
 	std::cout << "Win by extinguishing all the fire before losing 80% of the land!.\n\n";
 }
 
+void GeneratorView::ToggleTracing()
+{
+	Exelius::TraceRecorder& recorder = Exelius::TraceRecorder::GetInstance();
+	if (!recorder.IsEnabled())
+	{
+		recorder.Clear();
+		recorder.SetEnabled(true);
+		std::cout << "Tracing started.\n";
+		return;
+	}
+
+	// A scope the refine task is still in when this stops can be left out of the file.
+	recorder.SetEnabled(false);
+
+	if (recorder.WriteChromeTrace(kTracePath))
+		std::cout << "Wrote " << recorder.GetEventCount() << " trace events to " << kTracePath << ", open it in about:tracing or ui.perfetto.dev.\n";
+	else
+		std::cout << "Could not write " << kTracePath << ".\n";
+}
+
+void GeneratorView::ToggleExploring()
+{
+	m_isExploring = !m_isExploring;
+	if (!m_isExploring)
+	{
+		std::cout << "Back to the fire.\n";
+		return;
+	}
+
+	// Start over the middle of the world, with the player in the middle of the window.
+	m_cameraPosition.x = (float)(m_exploreWorld.GetWorldWidth() - kWorldWidth) / 2.0f;
+	m_cameraPosition.y = (float)(m_exploreWorld.GetWorldHeight() - kWorldHeight) / 2.0f;
+	m_pPlayerTransform->SetX(kWorldWidth / 2);
+	m_pPlayerTransform->SetY(kWorldHeight / 2);
+	std::cout << "Exploring, the arrow keys steer.\n";
+}
+
+void GeneratorView::UpdateExploring(float deltaTime)
+{
+	auto* pKeyboard = Exelius::IApplicationLayer::GetInstance()->GetKeyboardInput();
+	if (pKeyboard->IsKeyPressed(Exelius::GenericKeyboard::Code::kCodeE))
+	{
+		ToggleExploring();
+		return;
+	}
+
+	if (pKeyboard->IsKeyPressed(Exelius::GenericKeyboard::Code::kCodeQ))
+	{
+		Exelius::IApplicationLayer::GetInstance()->GetWindow()->Quit();
+		return;
+	}
+
+	m_pUIText->ChangeText(("Exploring " + std::to_string((int)m_cameraPosition.x) + ", " + std::to_string((int)m_cameraPosition.y)
+		+ "\t" + std::to_string(m_exploreWorld.GetCachedChunkCount()) + " chunks cached").c_str(), 255, 255, 255);
+
+	SetMovementVector();
+
+	const float faceDirection = ((std::atan2(m_playerMovement.y, m_playerMovement.x) * 180.0f) / Exelius::PI) + 90.0f;
+	m_pPlayerTexture->SetAngle(faceDirection);
+
+	// The player stays in the middle of the window, the world moves under it.
+	const float maxX = (float)(m_exploreWorld.GetWorldWidth() - kWorldWidth);
+	const float maxY = (float)(m_exploreWorld.GetWorldHeight() - kWorldHeight);
+	m_cameraPosition.x = std::clamp(m_cameraPosition.x + m_playerMovement.x * kExploreSpeed * deltaTime, 0.0f, maxX);
+	m_cameraPosition.y = std::clamp(m_cameraPosition.y + m_playerMovement.y * kExploreSpeed * deltaTime, 0.0f, maxY);
+
+	m_exploreWorld.Update((int)m_cameraPosition.x, (int)m_cameraPosition.y, kWorldWidth, kWorldHeight);
+	m_cloudGenerator.UpdateClouds(deltaTime);
+}
+
 void GeneratorView::SetMovementVector()
 {
 	auto* pKeyboard = Exelius::IApplicationLayer::GetInstance()->GetKeyboardInput();
@@ -208,26 +324,33 @@ void GeneratorView::ForcePlayerBounds()
 
 bool GeneratorView::IsPlayerOverWater()
 {
-	// Get all the tiles underneath the player.
-	auto tiles = m_worldMap.GetTilesOfColorInArea({ (int)m_pPlayerTransform->GetX(), (int)m_pPlayerTransform->GetY(), 48, 48 }, kOcean);
+	// Count the water tiles underneath the player.
+	const size_t waterTiles = m_worldMap.CountBiomeInArea({ (int)m_pPlayerTransform->GetX(), (int)m_pPlayerTransform->GetY(), 48, 48 }, BiomeId::kOcean);
 
-	if (tiles.size() < 1500)
-		return false;
+	return waterTiles >= 1500;
+}
 
-	// If there is a non-water tile in the group
-	/*for (auto tile : tiles)
-	{
-		if (m_worldMap.GetTileColor(tile) != kOcean.GetHex())
-			return false;
-	}*/
+void GeneratorView::PrintClimateUnderPlayer()
+{
+	const size_t tile = m_worldMap.GetTileIndex({ m_pPlayerTransform->GetX() + 24.0f, m_pPlayerTransform->GetY() + 24.0f });
+	if (tile >= (size_t)m_worldMap.GetMapWidth() * m_worldMap.GetMapHeight())
+		return;
 
-	return true;
+	std::cout << "Height " << m_worldMap.GetTileValue<TilePlane::kHeight>(tile)
+		<< ", Tempurature " << m_worldMap.GetTileValue<TilePlane::kTempurature>(tile)
+		<< ", Moisture " << m_worldMap.GetTileValue<TilePlane::kMoisture>(tile) << "\n";
 }
 
 void GeneratorView::ExtinguishFire()
 {
+	const Exelius::Rectangle area = { (int)m_pPlayerTransform->GetX(), (int)m_pPlayerTransform->GetY(), 48, 48 };
+
+	// Most of the time there is no fire under the player, no need to collect the tiles.
+	if (m_worldMap.CountBiomeInArea(area, BiomeId::kFire) == 0)
+		return;
+
 	// Get all the tiles underneath the player.
-	auto tiles = m_worldMap.GetTilesOfColorInArea({ (int)m_pPlayerTransform->GetX(), (int)m_pPlayerTransform->GetY(), 48, 48 }, Exelius::Colors::Flame);
+	auto tiles = m_worldMap.GetTilesOfBiomeInArea(area, BiomeId::kFire);
 
 	// If there is a non-water tile in the group
 	for (auto tile : tiles)
@@ -238,11 +361,12 @@ void GeneratorView::ExtinguishFire()
 
 void GeneratorView::RestartGame()
 {
-	// Reset the generator to default settings and tilemap to new map.
+	// Reset the generator to default settings. The map shows a preview of the new world right away,
+	// the fire starts once UpdateWorldMap has the full resolution world.
 	m_worldGenerator.ResetGenerator();
-	m_worldGenerator.GenerateWorld(m_worldMap);
+	m_worldGenerator.Start(kWorldWidth, kWorldHeight, true);
 	m_fireGenerator.ResetFireGenerator();
-	m_fireGenerator.StartFire(m_worldMap);
+	UpdateWorldMap();
 
 	m_pPlayerTransform->SetX(kWorldWidth / 2);
 	m_pPlayerTransform->SetY(kWorldHeight / 2);
@@ -250,3 +374,12 @@ void GeneratorView::RestartGame()
 	m_playerMovement = { 0.0f, -1.0f };
 	m_waterTankFull = false;
 }
+
+
+bool GeneratorView::UpdateWorldMap()
+{
+	if (m_worldGenerator.UpdateMap(m_worldMap) && m_worldGenerator.IsFinished())
+		m_fireGenerator.StartFire(m_worldMap);
+
+	return m_worldGenerator.IsFinished();
+}
\ No newline at end of file
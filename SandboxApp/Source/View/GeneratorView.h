@@ -5,7 +5,8 @@
 #include <Components/TextureComponent.h>
 #include <Components/TextRenderComponent.h>
 
-#include "World/WorldGeneration/WorldGenerator.h"
+#include "World/WorldGeneration/ChunkedWorld.h"
+#include "World/WorldGeneration/ProgressiveWorldGenerator.h"
 #include "World/CloudGeneration/CloudGenerator.h"
 #include "World/FireGeneration/FireGenerator.h"
 
@@ -16,6 +17,13 @@ public:
 
 	static const int kLosePercent = 80;
 
+	// The world 'E' flies over, in chunks of ChunkedWorld::kChunkSize tiles per side.
+	static constexpr unsigned int kExploreWorldChunks = 16;
+	static constexpr unsigned long long kExploreSeed = 1;
+
+	// Tiles per second the camera moves while exploring.
+	static constexpr float kExploreSpeed = 400.0f;
+
 	//------------------------------------------------------------------------------------------------------
 	// View Functions
 	//------------------------------------------------------------------------------------------------------
@@ -37,18 +45,58 @@ private:
 
 	bool IsPlayerOverWater();
 
+	/// <summary>
+	/// Print the height, tempurature and moisture of the tile under the middle of the player.
+	/// </summary>
+	void PrintClimateUnderPlayer();
+
 	void ExtinguishFire();
 
 	void RestartGame();
 
-	WorldGenerator m_worldGenerator;
+	/// <summary>
+	/// Start recording a trace, or stop and write it to kTracePath.
+	/// </summary>
+	void ToggleTracing();
+
+	/// <summary>
+	/// Switch between the game and flying the camera over m_exploreWorld. The fire waits while exploring.
+	/// </summary>
+	void ToggleExploring();
+
+	/// <summary>
+	/// Move the camera the way the player faces, keep it in the world, and stream the chunks around it.
+	/// </summary>
+	void UpdateExploring(float deltaTime);
+
+	static constexpr const char* kTracePath = "trace.json";
 
-	CloudGenerator m_cloudGenerator;
+	/// <summary>
+	/// Copy the latest world level into m_worldMap, and start the fire once the world is final.
+	/// </summary>
+	/// <returns>(bool) True once the world is final.</returns>
+	bool UpdateWorldMap();
+
+	// The noise the world and clouds are generated with. Exelius::SimplexNoise is the other option.
+	using NoiseBackend = Exelius::PerlinNoise;
+
+	// Regenerates coarse to fine, m_worldMap gets each level as it finishes. The fire starts once the
+	// full resolution level is in.
+	ProgressiveWorldGenerator<NoiseBackend> m_worldGenerator;
+
+	CloudGenerator<NoiseBackend> m_cloudGenerator;
 
 	FireGenerator m_fireGenerator;
 
 	TileMap m_worldMap;
 
+	// A world too large for the window, streamed around the camera while exploring.
+	ChunkedWorld<NoiseBackend> m_exploreWorld;
+	bool m_isExploring;
+
+	// Top left tile of the view into m_exploreWorld.
+	Exelius::Vector2f m_cameraPosition;
+
 	Exelius::TransformComponent* m_pPlayerTransform;
 	Exelius::TextureComponent* m_pPlayerTexture;
 	Exelius::Vector2f m_playerMovement;
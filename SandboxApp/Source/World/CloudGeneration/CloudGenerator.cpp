@@ -4,79 +4,61 @@
 #include <ApplicationLayer.h>
 #include <Managers/Graphics.h>
 
-CloudGenerator::CloudGenerator()
+#include <algorithm>
+#include <vector>
+
+template <class NoiseBackend>
+CloudGenerator<NoiseBackend>::CloudGenerator()
 	: m_renderOffset(0.0f)
 {
 	ResetGenerator();
-
-	//Create all of the worker threads that we will need.
-	m_pThreadPool = new std::thread[kMaxThreads];
-}
-
-CloudGenerator::~CloudGenerator()
-{
-	delete[] m_pThreadPool;
 }
 
-void CloudGenerator::ResetGenerator()
+template <class NoiseBackend>
+void CloudGenerator<NoiseBackend>::ResetGenerator()
 {
 	m_cloudParameters.SetParameters(kDefaultCloudOctaves, kDefaultCloudInputRange, kDefaultCloudPersistance, (unsigned int)m_rand.Rand());
 }
 
-void CloudGenerator::GenerateClouds()
+template <class NoiseBackend>
+void CloudGenerator<NoiseBackend>::GenerateClouds()
 {
-	size_t threadStride = (kCloudWidth * kCloudHeight) / (kMaxThreads + 1);
-
-	size_t startIndex = 0;
-	size_t endIndex = threadStride;
+	EXELIUS_TRACE_SCOPE("CloudGenerator::GenerateClouds");
 
 	//-----------------------------------------------------------------------------------------------------
 	// Height Noise Generation
 	//-----------------------------------------------------------------------------------------------------
 	TileMap cloudMap(kCloudWidth, kCloudHeight);
-	m_noise.SetSeed(m_cloudParameters.GetSeed());
+	unsigned int layerSeed = m_cloudParameters.GetSeed();
+	m_noise.SetSeed(layerSeed);
+	m_pCloudFalloff = FalloffTable::Get(kCloudWidth, kCloudHeight, cloudMap.GetTileWidth(), cloudMap.GetTileHeight(), kCloudNoiseExponent);
 
-	// Generate the height noise values.
-	for (size_t i = 0; i < kMaxThreads; ++i)
+	// Rows are handed out to the job system in small jobs. The jobs only read the layer's seed.
+	Exelius::JobSystem& jobSystem = Exelius::JobSystem::GetInstance();
+	auto generateRows = [this, &cloudMap, &layerSeed](size_t firstRow, size_t endRow)
 	{
-		m_pThreadPool[i] = std::thread(&CloudGenerator::GenerateCloudNoise, this, startIndex, endIndex, std::ref(cloudMap));
-		startIndex += threadStride;
-		endIndex += threadStride;
-	}
+		EXELIUS_TRACE_SCOPE("Cloud rows");
+		GenerateCloudNoise(firstRow * kCloudWidth, endRow * kCloudWidth, layerSeed, cloudMap);
+	};
 
-	GenerateCloudNoise(startIndex, kCloudWidth * kCloudHeight, cloudMap);
+	// Generate the height noise values.
+	jobSystem.ParallelFor(0, kCloudHeight, kRowsPerJob, generateRows);
 
-	//Wait for the threads to complete the read task.
-	for (unsigned int i = 0; i < kMaxThreads; ++i)
-	{
-		m_pThreadPool[i].join();
-	}
 	auto& graphics = Exelius::IApplicationLayer::GetInstance()->GetGraphicsRef();
 	m_cloudTextureA = graphics->GetTextureFromPixels(cloudMap.GetTiles(), kCloudWidth, kCloudHeight, kCloudWidth * 4);
 
 
-	m_noise.SetSeed((unsigned int)m_rand.Rand());
+	layerSeed = (unsigned int)m_rand.Rand();
+	m_noise.SetSeed(layerSeed);
 
 	// Generate the height noise values.
-	for (size_t i = 0; i < kMaxThreads; ++i)
-	{
-		m_pThreadPool[i] = std::thread(&CloudGenerator::GenerateCloudNoise, this, startIndex, endIndex, std::ref(cloudMap));
-		startIndex += threadStride;
-		endIndex += threadStride;
-	}
-
-	GenerateCloudNoise(startIndex, kCloudWidth * kCloudHeight, cloudMap);
-
-	//Wait for the threads to complete the read task.
-	for (unsigned int i = 0; i < kMaxThreads; ++i)
-	{
-		m_pThreadPool[i].join();
-	}
+	jobSystem.ParallelFor(0, kCloudHeight, kRowsPerJob, generateRows);
 
 	m_cloudTextureB = graphics->GetTextureFromPixels(cloudMap.GetTiles(), kCloudWidth, kCloudHeight, kCloudWidth * 4);
 }
 
-void CloudGenerator::UpdateClouds([[maybe_unused]] float deltaTime)
+template <class NoiseBackend>
+void CloudGenerator<NoiseBackend>::UpdateClouds([[maybe_unused]] float deltaTime)
 {
 	m_renderOffset += deltaTime * kCloudScrollSpeedMax;
 	if (m_renderOffset > kCloudWidth)
@@ -85,28 +67,49 @@ void CloudGenerator::UpdateClouds([[maybe_unused]] float deltaTime)
 	}
 }
 
-void CloudGenerator::Render()
+template <class NoiseBackend>
+void CloudGenerator<NoiseBackend>::Render()
 {
 	auto& graphics = Exelius::IApplicationLayer::GetInstance()->GetGraphicsRef();
 	graphics->DrawTexture(m_cloudTextureA.get(), (int)m_renderOffset, 0, kCloudWidth, kCloudHeight);
 	graphics->DrawTexture(m_cloudTextureB.get(), (int)m_renderOffset - kCloudWidth, 0, kCloudWidth, kCloudHeight);
 }
 
-void CloudGenerator::GenerateCloudNoise(size_t startIndex, size_t endIndex, TileMap& map)
+template <class NoiseBackend>
+void CloudGenerator<NoiseBackend>::GenerateCloudNoise(size_t startIndex, size_t endIndex, unsigned int seedOverride, TileMap& map)
 {
-	m_noise.SetSeed(m_cloudParameters.GetSeed());
-	for (size_t i = startIndex; i < endIndex; ++i)
+	std::vector<float> cloudNoiseRow(kCloudWidth);
+	typename NoiseBackend::RowCache cloudCache;
+	const float tileStep = (float)map.GetTileWidth();
+
+	size_t rowStartIndex = startIndex;
+	while (rowStartIndex < endIndex)
 	{
-		const Exelius::Vector2f gridPoint = map.GetTilePosition(i);
+		// A thread's stripe does not have to start or end on a row boundary.
+		const size_t rowEndIndex = std::min(endIndex, ((rowStartIndex / kCloudWidth) + 1) * kCloudWidth);
+		const size_t rowCount = rowEndIndex - rowStartIndex;
+		const Exelius::Vector2f rowStartPoint = map.GetTilePosition(rowStartIndex);
 
-		float cloudNoise = m_noise.GetAverageNoise(gridPoint.x, gridPoint.y,
+		NoiseBackend::GetAverageNoiseRow(cloudCache, rowStartPoint.x, tileStep, rowStartPoint.y, cloudNoiseRow.data(), rowCount,
 			(float)kCloudWidth / kCloudNoiseDivisor, (float)kCloudHeight / kCloudNoiseDivisor,
-			m_cloudParameters.GetInputRange(), m_cloudParameters.GetOctaves(), m_cloudParameters.GetPersistance());
+			m_cloudParameters.GetInputRange(), m_cloudParameters.GetOctaves(), m_cloudParameters.GetPersistance(), seedOverride);
+		m_pCloudFalloff->ApplySpan(rowStartIndex, rowCount, cloudNoiseRow.data());
+
+		for (size_t i = 0; i < rowCount; ++i)
+		{
+			const Exelius::Vector2f gridPoint = map.GetTilePosition(rowStartIndex + i);
+
+			const float cloudNoise = cloudNoiseRow[i];
 
-		cloudNoise = (cloudNoise * powf(sinf(Exelius::PI * (gridPoint.y / (float)kCloudHeight)) * sinf(Exelius::PI * (gridPoint.x / (float)kCloudWidth)), kCloudNoiseExponent));
+			Exelius::Color hexColor;
+			hexColor.a = (uint8_t)(cloudNoise * 150.0f);
+			map.SetTileColor(gridPoint, hexColor);
+		}
 
-		Exelius::Color hexColor;
-		hexColor.a = (uint8_t)(cloudNoise * 150.0f);
-		map.SetTileColor(gridPoint, hexColor);
+		rowStartIndex = rowEndIndex;
 	}
-}
\ No newline at end of file
+}
+
+// The generator is only ever built against these backends, so the definitions can stay out of the header.
+template class CloudGenerator<Exelius::PerlinNoise>;
+template class CloudGenerator<Exelius::SimplexNoise>;
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
 #include "World/GenertionSettings/NoiseParameters.h"
+#include "World/Masks/FalloffTable.h"
 #include "World/TileMap/TileMap.h"
+#include <Utilities/JobSystem.h>
+#include <Utilities/TraceRecorder.h>
 #include <Utilities/Random/Noise/PerlinNoise.h>
+#include <Utilities/Random/Noise/SimplexNoise.h>
 #include <Utilities/Random/Random.h>
 
-#include <thread>
+#include <memory>
 
 namespace Exelius
 {
@@ -17,15 +21,22 @@ namespace Exelius
 ///		Cloud generation is just a Perlin Noise height map. There are
 ///		levels in the map that effects the level of transparency of the
 ///		pixels.
+/// Noise:
+///		NoiseBackend is the noise type the clouds are generated with,
+///		Exelius::PerlinNoise or Exelius::SimplexNoise.
 /// </summary>
+template <class NoiseBackend>
 class CloudGenerator
 {
-	static constexpr unsigned int kMaxThreads = 7;
-	std::thread* m_pThreadPool = nullptr;
+	// Rows per job system job.
+	static constexpr size_t kRowsPerJob = 4;
 
-	Exelius::PerlinNoise m_noise;
+	NoiseBackend m_noise;
 	Exelius::Random m_rand;
 
+	// Fades the clouds out towards the map edges.
+	std::shared_ptr<const FalloffTable> m_pCloudFalloff;
+
 	std::shared_ptr<Exelius::ITexture> m_cloudTextureA;
 	std::shared_ptr<Exelius::ITexture> m_cloudTextureB;
 
@@ -35,7 +46,6 @@ public:
 	NoiseParameters m_cloudParameters;
 
 	CloudGenerator();
-	~CloudGenerator();
 
 	CloudGenerator(const CloudGenerator&) = default;
 	CloudGenerator(CloudGenerator&&) = default;
@@ -58,5 +68,9 @@ public:
 
 private:
 
-	void GenerateCloudNoise(size_t startIndex, size_t endIndex, TileMap& map);
+	/// <summary>
+	/// Fill tiles [startIndex, endIndex) of map with cloud noise. Runs on several job system threads at
+	/// once, so it only reads the generator; the layer's seed is passed in.
+	/// </summary>
+	void GenerateCloudNoise(size_t startIndex, size_t endIndex, unsigned int seedOverride, TileMap& map);
 };
\ No newline at end of file
@@ -1,18 +1,49 @@
 #include "FireGenerator.h"
 #include "World/GenertionSettings/GeneratorConfig.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+/// <summary>
+/// A fire lifetime as the FireState plane keeps it: fire ticks left, rounded up.
+/// </summary>
+static uint8_t GetFireState(float lifetime)
+{
+	return (uint8_t)std::clamp(std::ceil(lifetime / kFireTickTime), 1.0f, 255.0f);
+}
+
 void FireGenerator::StartFire(TileMap& map)
 {
+	EXELIUS_TRACE_SCOPE("FireGenerator::StartFire");
+
 	m_pTileMap = &map;
-	for (size_t i = 0; i < m_pTileMap->GetTiles().size(); ++i)
+
+	// The plane is kept by the map, a restart only clears it.
+	std::vector<uint8_t>& fireStates = m_pTileMap->AddPlane<TilePlane::kFireState>();
+	std::fill(fireStates.begin(), fireStates.end(), (uint8_t)0);
+
+	// One ignition roll per tile index, hashed a batch at a time.
+	const unsigned int ignitionSeed = (unsigned int)m_rand.Rand();
+	std::array<float, kIgnitionBatchSize> ignitionChances;
+
+	const size_t tileCount = (size_t)m_pTileMap->GetMapWidth() * (size_t)m_pTileMap->GetMapHeight();
+	for (size_t i = 0; i < tileCount; ++i)
 	{
-		const float chance = m_rand.FRandomRange(0.0f, 1.0f);
-		auto tile = map.GetTileColor(i);
+		const size_t batchIndex = i % kIgnitionBatchSize;
+		if (batchIndex == 0)
+		{
+			Exelius::SquirrelNoise::GetUniform1DNoiseSequence((int)i, ignitionChances.data(),
+				std::min(kIgnitionBatchSize, tileCount - i), ignitionSeed);
+		}
 
-		if (tile == kGrassland.GetHex()
-			|| tile == kForest.GetHex()
-			|| tile == kSavanna.GetHex()
-			|| tile == kSwamp.GetHex())
+		const float chance = ignitionChances[batchIndex];
+		const BiomeId tile = map.GetTileBiome(i);
+
+		if (tile == BiomeId::kGrassland
+			|| tile == BiomeId::kForest
+			|| tile == BiomeId::kSavanna
+			|| tile == BiomeId::kSwamp)
 		{
 			++m_flamableTileCount;
 		}
@@ -52,6 +83,9 @@ bool FireGenerator::PropagateFire(float deltaTime)
 	if (m_fireTiles.empty() && m_newFire.empty())
 		return true;
 
+	// Only the ticks that spread fire are traced, the frames in between do nothing.
+	EXELIUS_TRACE_SCOPE("FireGenerator::PropagateFire");
+
 	for (auto tile : m_newFire)
 	{
 		m_fireTiles.emplace(tile, kFireLifetime);
@@ -70,6 +104,7 @@ bool FireGenerator::PropagateFire(float deltaTime)
 		}
 		else
 		{
+			m_pTileMap->SetTileValue<TilePlane::kFireState>(it->first, GetFireState(it->second));
 			TryIgniteNeighbor(it->first);
 			++it;
 		}
@@ -104,43 +139,43 @@ void FireGenerator::ExtinguishTile(size_t tileIndex)
 
 void FireGenerator::IgniteTile(size_t index)
 {
-	m_pTileMap->SetTileColor(index, Exelius::Colors::Flame);
+	m_pTileMap->SetTileBiome(index, BiomeId::kFire);
+	m_pTileMap->SetTileValue<TilePlane::kFireState>(index, GetFireState(kFireLifetime));
 	m_newFire.emplace_back(index);
 	--m_flamableTileCount;
 }
 
 void FireGenerator::InternalExtinguishTile(size_t index)
 {
-	m_pTileMap->SetTileColor(index, kBlackScorch);
+	m_pTileMap->SetTileBiome(index, BiomeId::kBlackScorch);
+	m_pTileMap->SetTileValue<TilePlane::kFireState>(index, 0);
 }
 
 void FireGenerator::TryIgniteNeighbor(size_t index)
 {
-	const auto& neighbors = m_pTileMap->GetTileNeighbors(index);
-
-	for (auto tile : neighbors)
+	for (size_t tile : m_pTileMap->GetTileNeighbors(index))
 	{
 		const float chance = m_rand.FRandomRange(0.0f, 1.0f);
-		auto tileColor = m_pTileMap->GetTileColor(tile);
+		const BiomeId tileBiome = m_pTileMap->GetTileBiome(tile);
 
-		if (tileColor == kOcean.GetHex())
+		if (tileBiome == BiomeId::kOcean)
 			continue;
-		if (tileColor == Exelius::Colors::Flame.GetHex())
+		if (tileBiome == BiomeId::kFire)
 			continue;
 
-		if (tileColor == kGrassland.GetHex() && chance <= kGrasslandBurnChance)
+		if (tileBiome == BiomeId::kGrassland && chance <= kGrasslandBurnChance)
 		{
 			IgniteTile(tile);
 		}
-		else if (tileColor == kForest.GetHex() && chance <= kForestBurnChance)
+		else if (tileBiome == BiomeId::kForest && chance <= kForestBurnChance)
 		{
 			IgniteTile(tile);
 		}
-		else if (tileColor == kSavanna.GetHex() && chance <= kSavannaBurnChance)
+		else if (tileBiome == BiomeId::kSavanna && chance <= kSavannaBurnChance)
 		{
 			IgniteTile(tile);
 		}
-		else if (tileColor == kSwamp.GetHex() && chance <= kSwampBurnChance)
+		else if (tileBiome == BiomeId::kSwamp && chance <= kSwampBurnChance)
 		{
 			IgniteTile(tile);
 		}
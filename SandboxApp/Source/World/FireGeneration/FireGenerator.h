@@ -1,11 +1,16 @@
 #pragma once
 #include "World/TileMap/TileMap.h"
 
+#include <Utilities/Random/Noise/SquirrelNoise.h>
 #include <Utilities/Random/Random.h>
+#include <Utilities/TraceRecorder.h>
 #include <unordered_map>
 
 class FireGenerator
 {
+	// Tiles are rolled for ignition in batches of this many hashes.
+	static constexpr size_t kIgnitionBatchSize = 1024;
+
 	Exelius::Random m_rand;
 
 	// This map represents all of the fire tiles in the world.
@@ -0,0 +1,75 @@
+#pragma once
+#include "World/GenertionSettings/GeneratorConfig.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------------------------
+// Biome Ids
+//----------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// What a tile is made of: every biome, plus the states fire leaves tiles in. TileMap stores one per
+/// tile, and the value is the id's index in kBiomeColors.
+/// </summary>
+enum class BiomeId : uint8_t
+{
+	kOcean,
+	kReef,
+	kRock,
+	kGlacier,
+	kSnow,
+	kDesert,
+	kDunes,
+	kCliff,
+	kSavanna,
+	kGrassland,
+	kForest,
+	kSwamp,
+	kFire,
+	kBlackScorch,
+	kError,
+
+	kCount
+};
+
+static constexpr Exelius::Color kBiomeColors[(size_t)BiomeId::kCount] =
+{
+	kOcean,
+	kReef,
+	kRock,
+	kGlacier,
+	kSnow,
+	kDesert,
+	kDunes,
+	kCliff,
+	kSavanna,
+	kGrassland,
+	kForest,
+	kSwamp,
+	Exelius::Colors::Flame,
+	kBlackScorch,
+	kError,
+};
+
+/// <summary>
+/// kBiomeColors as packed hex colors, the form the tile color plane is uploaded in.
+/// </summary>
+struct BiomePalette
+{
+	uint32_t m_colors[(size_t)BiomeId::kCount];
+
+	constexpr uint32_t GetHex(BiomeId biome) const { return m_colors[(size_t)biome]; }
+};
+
+constexpr BiomePalette BuildBiomePalette()
+{
+	BiomePalette palette = {};
+	for (size_t i = 0; i < (size_t)BiomeId::kCount; ++i)
+	{
+		palette.m_colors[i] = kBiomeColors[i].GetHex();
+	}
+	return palette;
+}
+
+static constexpr BiomePalette kBiomePalette = BuildBiomePalette();
\ No newline at end of file
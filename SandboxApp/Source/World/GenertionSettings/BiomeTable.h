@@ -0,0 +1,181 @@
+#pragma once
+#include "World/GenertionSettings/BiomeId.h"
+#include "World/GenertionSettings/GeneratorConfig.h"
+
+#include <stddef.h>
+
+//----------------------------------------------------------------------------------------------------
+// Biome Lookup Table
+//----------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Biome classification as a table lookup instead of a branch per threshold.
+///
+/// Height, tempurature and moisture are each turned into a band by counting the thresholds of
+/// the Biome Configuration they are past, and the three bands index a table of biomes. The table
+/// is built at compile time by running ClassifyBiome (the threshold cascade) on a value inside
+/// every band, so changing a threshold in GeneratorConfig.h changes the table with it.
+/// </summary>
+namespace BiomeTable
+{
+	static constexpr size_t kNumHeightBands = 4;
+	static constexpr size_t kNumTempuratureBands = 5;
+	static constexpr size_t kNumMoistureBands = 5;
+	static constexpr size_t kNumBiomeEntries = kNumHeightBands * kNumTempuratureBands * kNumMoistureBands;
+
+	// The thresholds between bands, in increasing order. Height is past kMountainRange at the threshold
+	// itself, every other band starts just after its threshold.
+	static constexpr float kHeightThresholds[kNumHeightBands - 1] = { kOceanRange, kReefRange, kMountainRange };
+	static constexpr float kTempuratureThresholds[kNumTempuratureBands - 1] = { kTundraRange, kTaigaRange, kTemperateRange, kTropicalRange };
+	static constexpr float kMoistureThresholds[kNumMoistureBands - 1] = { kDuneMoisture, kSavannaMoisture, kSnowMoisture, kGrasslandMoisture };
+
+	static_assert(kOceanRange < kReefRange && kReefRange < kMountainRange, "Height thresholds are out of order.");
+	static_assert(kTundraRange < kTaigaRange && kTaigaRange < kTemperateRange && kTemperateRange < kTropicalRange, "Tempurature thresholds are out of order.");
+	static_assert(kDuneMoisture < kSavannaMoisture && kSavannaMoisture < kSnowMoisture && kSnowMoisture < kGrasslandMoisture, "Moisture thresholds are out of order.");
+
+	constexpr size_t GetHeightBand(float heightValue)
+	{
+		return (size_t)(heightValue > kOceanRange) + (size_t)(heightValue > kReefRange) + (size_t)(heightValue >= kMountainRange);
+	}
+
+	constexpr size_t GetTempuratureBand(float tempValue)
+	{
+		return (size_t)(tempValue > kTundraRange) + (size_t)(tempValue > kTaigaRange)
+			+ (size_t)(tempValue > kTemperateRange) + (size_t)(tempValue > kTropicalRange);
+	}
+
+	constexpr size_t GetMoistureBand(float moistureValue)
+	{
+		return (size_t)(moistureValue > kDuneMoisture) + (size_t)(moistureValue > kSavannaMoisture)
+			+ (size_t)(moistureValue > kSnowMoisture) + (size_t)(moistureValue > kGrasslandMoisture);
+	}
+
+	constexpr size_t GetBiomeIndex(size_t heightBand, size_t tempuratureBand, size_t moistureBand)
+	{
+		return (heightBand * kNumTempuratureBands + tempuratureBand) * kNumMoistureBands + moistureBand;
+	}
+
+	/// <summary>
+	/// The biome of a tile, one threshold at a time. Only used to build the table.
+	/// </summary>
+	constexpr BiomeId ClassifyBiome(float heightValue, float tempValue, float moistureValue)
+	{
+		if (heightValue <= kOceanRange)
+			return BiomeId::kOcean;
+
+		if (heightValue <= kReefRange)
+			return BiomeId::kReef;
+
+		if (heightValue >= kMountainRange)
+			return BiomeId::kRock;
+
+		//The tempurature range is under -5 C
+		if (tempValue <= kTundraRange)
+			return BiomeId::kGlacier;
+
+		//The tempurature range is under 0 C
+		if (tempValue <= kTaigaRange)
+			return (moistureValue <= kSnowMoisture) ? BiomeId::kSnow : BiomeId::kGrassland;
+
+		//The tempurature range is under 18 C
+		if (tempValue <= kTemperateRange)
+		{
+			if (moistureValue <= kSavannaMoisture)
+				return BiomeId::kSavanna;
+			if (moistureValue <= kGrasslandMoisture)
+				return BiomeId::kGrassland;
+			return BiomeId::kSwamp;
+		}
+
+		//The tempurature range is under 30 C
+		if (tempValue <= kTropicalRange)
+			return (moistureValue <= kDuneMoisture) ? BiomeId::kDunes : BiomeId::kDesert;
+
+		return BiomeId::kError;
+	}
+
+	/// <summary>
+	/// A value inside band of the given thresholds: halfway between two thresholds, or one past the first/last.
+	/// </summary>
+	template <size_t kNumThresholds>
+	constexpr float GetBandValue(const float (&thresholds)[kNumThresholds], size_t band)
+	{
+		if (band == 0)
+			return thresholds[0] - 1.0f;
+
+		if (band == kNumThresholds)
+			return thresholds[kNumThresholds - 1] + 1.0f;
+
+		return (thresholds[band - 1] + thresholds[band]) * 0.5f;
+	}
+
+	struct Table
+	{
+		BiomeId m_biomes[kNumBiomeEntries];
+	};
+
+	constexpr Table BuildTable()
+	{
+		Table table = {};
+		for (size_t heightBand = 0; heightBand < kNumHeightBands; ++heightBand)
+		{
+			for (size_t tempuratureBand = 0; tempuratureBand < kNumTempuratureBands; ++tempuratureBand)
+			{
+				for (size_t moistureBand = 0; moistureBand < kNumMoistureBands; ++moistureBand)
+				{
+					table.m_biomes[GetBiomeIndex(heightBand, tempuratureBand, moistureBand)] = ClassifyBiome(
+						GetBandValue(kHeightThresholds, heightBand),
+						GetBandValue(kTempuratureThresholds, tempuratureBand),
+						GetBandValue(kMoistureThresholds, moistureBand));
+				}
+			}
+		}
+		return table;
+	}
+
+	static constexpr Table kTable = BuildTable();
+
+	/// <summary>
+	/// The biome for interpreted height, tempurature and moisture values (see WorldGenerator). Same result
+	/// as ClassifyBiome.
+	/// </summary>
+	constexpr BiomeId GetBiome(float heightValue, float tempValue, float moistureValue)
+	{
+		return kTable.m_biomes[GetBiomeIndex(GetHeightBand(heightValue), GetTempuratureBand(tempValue), GetMoistureBand(moistureValue))];
+	}
+
+	/// <summary>
+	/// True if GetBiome and ClassifyBiome agree on and around every threshold.
+	/// </summary>
+	constexpr bool MatchesClassifyBiome()
+	{
+		constexpr float kOffsets[] = { -1.0f, 0.0f, 1.0f };
+
+		for (float height : kHeightThresholds)
+		{
+			for (float temp : kTempuratureThresholds)
+			{
+				for (float moisture : kMoistureThresholds)
+				{
+					for (float heightOffset : kOffsets)
+					{
+						for (float tempOffset : kOffsets)
+						{
+							for (float moistureOffset : kOffsets)
+							{
+								const float h = height + heightOffset;
+								const float t = temp + tempOffset;
+								const float m = moisture + moistureOffset;
+								if (GetBiome(h, t, m) != ClassifyBiome(h, t, m))
+									return false;
+							}
+						}
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	static_assert(MatchesClassifyBiome(), "The biome table does not match ClassifyBiome.");
+}
\ No newline at end of file
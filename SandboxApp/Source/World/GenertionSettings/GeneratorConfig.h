@@ -9,6 +9,11 @@
 static constexpr unsigned int kWorldWidth = 1280;
 static constexpr unsigned int kWorldHeight = 720;
 
+// The extent the height and moisture noise is stretched over, in tiles. It doesn't follow the size of the
+// world being generated, so a larger world has more terrain at the same detail per tile, not larger terrain.
+static constexpr float kNoiseWorldWidth = (float)kWorldWidth;
+static constexpr float kNoiseWorldHeight = (float)kWorldHeight;
+
 //----------------------------------------------------------------------------------------------------
 // Default Height Noise and Value Parameters
 //----------------------------------------------------------------------------------------------------
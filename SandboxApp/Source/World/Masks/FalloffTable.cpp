@@ -0,0 +1,81 @@
+#include "FalloffTable.h"
+
+#include <Utilities/Math/Math.h>
+
+#include <cmath>
+#include <mutex>
+
+FalloffTable::FalloffTable(unsigned int width, unsigned int height, unsigned int tileWidth, unsigned int tileHeight, float exponent)
+	: m_rowFactors(height)
+	, m_columnFactors(width)
+	, m_width(width)
+	, m_height(height)
+	, m_tileWidth(tileWidth)
+	, m_tileHeight(tileHeight)
+	, m_exponent(exponent)
+{
+	// Same tile positions as TileMap::GetTilePosition.
+	for (unsigned int row = 0; row < height; ++row)
+	{
+		const float y = (float)(row * tileHeight);
+		m_rowFactors[row] = powf(sinf(Exelius::PI * (y / (float)height)), exponent);
+	}
+
+	for (unsigned int column = 0; column < width; ++column)
+	{
+		const float x = (float)(column * tileWidth);
+		m_columnFactors[column] = powf(sinf(Exelius::PI * (x / (float)width)), exponent);
+	}
+}
+
+std::shared_ptr<const FalloffTable> FalloffTable::Get(unsigned int width, unsigned int height, unsigned int tileWidth, unsigned int tileHeight, float exponent)
+{
+	// The cache only holds weak references, so a table lives as long as a generator keeps it. Streamed
+	// chunks and progressive levels ask for many sizes over a run; only the ones still in use stay.
+	static std::mutex s_tableLock;
+	static std::vector<std::weak_ptr<const FalloffTable>> s_tables;
+
+	std::lock_guard<std::mutex> lock(s_tableLock);
+
+	size_t i = 0;
+	while (i < s_tables.size())
+	{
+		std::shared_ptr<const FalloffTable> pTable = s_tables[i].lock();
+		if (!pTable)
+		{
+			// Drop tables nobody holds anymore.
+			s_tables[i] = std::move(s_tables.back());
+			s_tables.pop_back();
+			continue;
+		}
+
+		if (pTable->Matches(width, height, tileWidth, tileHeight, exponent))
+			return pTable;
+
+		++i;
+	}
+
+	auto pTable = std::make_shared<const FalloffTable>(width, height, tileWidth, tileHeight, exponent);
+	s_tables.emplace_back(pTable);
+	return pTable;
+}
+
+void FalloffTable::ApplySpan(size_t startIndex, size_t count, float* pInOut, size_t columnStep) const
+{
+	const float rowFactor = m_rowFactors[startIndex / m_width];
+	const float* pColumnFactors = m_columnFactors.data() + (startIndex % m_width);
+
+	if (columnStep == 1)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			pInOut[i] *= rowFactor * pColumnFactors[i];
+		}
+		return;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		pInOut[i] *= rowFactor * pColumnFactors[i * columnStep];
+	}
+}
\ No newline at end of file
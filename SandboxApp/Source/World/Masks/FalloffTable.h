@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// The sine falloff the generators mask their noise with:
+///		powf(sinf(PI * y / height) * sinf(PI * x / width), exponent)
+///
+/// pow(a * b, e) == pow(a, e) * pow(b, e), so the mask is stored as one factor per row and one per
+/// column and a pixel costs a single multiply instead of two sines and a pow. The row factors on their
+/// own are the latitude curve the tempurature gradient uses.
+///
+/// Tables are immutable once built and shared through Get, so every generator working on the same map
+/// size and exponent reads the same table. A table is freed once the last generator holding it lets go.
+/// </summary>
+class FalloffTable
+{
+	std::vector<float> m_rowFactors;
+	std::vector<float> m_columnFactors;
+
+	unsigned int m_width;
+	unsigned int m_height;
+	unsigned int m_tileWidth;
+	unsigned int m_tileHeight;
+	float m_exponent;
+
+public:
+	FalloffTable(unsigned int width, unsigned int height, unsigned int tileWidth, unsigned int tileHeight, float exponent);
+
+	/// <summary>
+	/// Returns the table for a map layout and exponent, building it if no generator holds one yet.
+	/// Safe to call from several threads.
+	/// </summary>
+	/// <param name="width">Number of tiles in a row.</param>
+	/// <param name="height">Number of rows.</param>
+	/// <param name="tileWidth">Distance between tiles in x, as TileMap::GetTilePosition uses it.</param>
+	/// <param name="tileHeight">Distance between rows in y, as TileMap::GetTilePosition uses it.</param>
+	/// <param name="exponent">Exponent the falloff is raised to.</param>
+	static std::shared_ptr<const FalloffTable> Get(unsigned int width, unsigned int height, unsigned int tileWidth, unsigned int tileHeight, float exponent);
+
+	/// <summary>
+	/// powf(sinf(PI * y / height), exponent) for the tile row.
+	/// </summary>
+	float GetRowFactor(size_t row) const { return m_rowFactors[row]; }
+
+	/// <summary>
+	/// powf(sinf(PI * x / width), exponent) for the tile column.
+	/// </summary>
+	float GetColumnFactor(size_t column) const { return m_columnFactors[column]; }
+
+	/// <summary>
+	/// Multiply count values along a row, starting at tile startIndex, by the falloff.
+	/// The values are columnStep tiles apart. The span must not cross a row boundary.
+	/// </summary>
+	void ApplySpan(size_t startIndex, size_t count, float* pInOut, size_t columnStep = 1) const;
+
+	bool Matches(unsigned int width, unsigned int height, unsigned int tileWidth, unsigned int tileHeight, float exponent) const
+	{
+		return (width == m_width && height == m_height && tileWidth == m_tileWidth && tileHeight == m_tileHeight && exponent == m_exponent);
+	}
+};
\ No newline at end of file
@@ -1,14 +1,29 @@
 #include "TileMap.h"
 
+#ifndef EXELIUS_HEADLESS
 #include <ApplicationLayer.h>
+#endif
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 
+#ifndef EXELIUS_HEADLESS
 TileMap::TileMap(unsigned int mapWidth, unsigned int mapHeight)
 	: m_tiles(((size_t)mapWidth * (size_t)mapHeight), kDefaultTileColor)
+	, m_biomes(((size_t)mapWidth * (size_t)mapHeight), kDefaultTileBiome)
 	, m_mapWidth(mapWidth)
 	, m_mapHeight(mapHeight)
 	, m_tileWidth(0)
 	, m_tileHeight(0)
+	, m_biomeCounts((size_t)BiomeId::kCount)
+	, m_areBiomeCountsStale(true)
+	, m_isCountingBiomes(false)
+	, m_pTexture(nullptr)
+	, m_dirtyColumnBegin(mapHeight, 0)
+	, m_dirtyColumnEnd(mapHeight, 0)
+	, m_firstDirtyRow(mapHeight)
+	, m_endDirtyRow(0)
+	, m_isAllDirty(true)
 {
 	auto windowDimensions = Exelius::IApplicationLayer::GetInstance()->GetWindow()->GetWindowDimensions();
 	m_tileWidth = windowDimensions.x / mapWidth;
@@ -25,45 +40,120 @@ TileMap::TileMap(unsigned int mapWidth, unsigned int mapHeight)
 
 	graphics->DrawPixelMap(m_tiles, true, m_mapWidth, m_mapHeight, m_mapWidth * 4);
 }
+#endif
+
+TileMap::TileMap(unsigned int mapWidth, unsigned int mapHeight, unsigned int tileWidth, unsigned int tileHeight)
+	: m_tiles(((size_t)mapWidth * (size_t)mapHeight), kDefaultTileColor)
+	, m_biomes(((size_t)mapWidth * (size_t)mapHeight), kDefaultTileBiome)
+	, m_mapWidth(mapWidth)
+	, m_mapHeight(mapHeight)
+	, m_tileWidth(tileWidth)
+	, m_tileHeight(tileHeight)
+	, m_biomeCounts((size_t)BiomeId::kCount)
+	, m_areBiomeCountsStale(true)
+	, m_isCountingBiomes(false)
+	, m_pTexture(nullptr)
+	, m_dirtyColumnBegin(mapHeight, 0)
+	, m_dirtyColumnEnd(mapHeight, 0)
+	, m_firstDirtyRow(mapHeight)
+	, m_endDirtyRow(0)
+	, m_isAllDirty(true)
+{
+	if (m_tileWidth <= 0 || m_tileHeight <= 0)
+	{
+		m_tileWidth = 1;
+		m_tileHeight = 1;
+		std::cout << "WARNING: Invalid width or height for tilemap. Setting to 1.\n";
+	}
+}
 
 void TileMap::ResetMap()
 {
 	// Fill in the tile data with the value for a white tile.
 	std::fill(m_tiles.begin(), m_tiles.end(), kDefaultTileColor);
+	std::fill(m_biomes.begin(), m_biomes.end(), kDefaultTileBiome);
+	m_areBiomeCountsStale = true;
+	m_isAllDirty = true;
+
+	// Planes are kept, only their values are reset.
+	std::apply([](auto&... planes)
+	{
+		(std::fill(planes.begin(), planes.end(), 0), ...);
+	}, m_planes);
 }
 
-void TileMap::RenderMap() const
+void TileMap::ApplyBiomePalette()
 {
-	auto& graphics = Exelius::IApplicationLayer::GetInstance()->GetGraphicsRef();
-	auto map = graphics->GetTextureFromPixels(m_tiles, m_mapWidth, m_mapHeight, m_mapWidth * 4);
+	ApplyBiomePalette(0, m_tiles.size());
+}
+
+void TileMap::ApplyBiomePalette(size_t firstTile, size_t endTile)
+{
+	for (size_t i = firstTile; i < endTile; ++i)
+	{
+		m_tiles[i] = kBiomePalette.GetHex(m_biomes[i]);
+	}
+}
+
+void TileMap::SetBiomeRow(unsigned int row, const BiomeId* pBiomes)
+{
+	std::copy_n(pBiomes, m_mapWidth, m_biomes.data() + (size_t)row * m_mapWidth);
 
-	graphics->DrawTexture(map.get(), 0, 0, 0, 0);
+	m_areBiomeCountsStale = true;
+	MarkTileDirty((size_t)row * m_mapWidth);
+	MarkTileDirty((size_t)row * m_mapWidth + m_mapWidth - 1);
 }
 
-// Returning by value because there should be a compiler optimization here,
-// and also there is a warning otherwise.
-std::vector<size_t> TileMap::GetTileNeighbors(size_t tileIndex) const
+#ifndef EXELIUS_HEADLESS
+void TileMap::RenderMap()
 {
-	std::vector<size_t> neighbors(4, 0x0000'0000);
+	auto& graphics = Exelius::IApplicationLayer::GetInstance()->GetGraphicsRef();
+	const unsigned int pitch = m_mapWidth * 4;
 
-	//If the tile is not on the left edge of the map...
-	if (tileIndex % (size_t)m_mapWidth != 0)
-		neighbors[0] = (tileIndex - 1); //Add the left neighbor.
+	if (!m_pTexture)
+	{
+		ApplyBiomePalette();
+		m_pTexture = graphics->GetTextureFromPixels(m_tiles, m_mapWidth, m_mapHeight, pitch);
+	}
+	else if (m_isAllDirty)
+	{
+		ApplyBiomePalette();
+		graphics->UpdateTexturePixels(m_pTexture.get(), m_tiles, pitch, { 0, 0, (int)m_mapWidth, (int)m_mapHeight });
+	}
+	else
+	{
+		// Runs of dirty rows go up as one rectangle, as wide as all their dirty columns. Fire changes
+		// scattered tiles, so this is a few small rectangles rather than one the size of the map.
+		unsigned int row = m_firstDirtyRow;
+		while (row < m_endDirtyRow)
+		{
+			if (m_dirtyColumnBegin[row] == m_dirtyColumnEnd[row])
+			{
+				++row;
+				continue;
+			}
 
-	//If the tile is not on the right edge of the map...
-	if (tileIndex % (size_t)m_mapWidth != ((size_t)m_mapWidth - 1))
-		neighbors[1] = (tileIndex + 1); //Add the right neighbor.
+			const unsigned int firstRow = row;
+			unsigned int firstColumn = m_dirtyColumnBegin[row];
+			unsigned int endColumn = m_dirtyColumnEnd[row];
+			for (; row < m_endDirtyRow && m_dirtyColumnBegin[row] != m_dirtyColumnEnd[row]; ++row)
+			{
+				firstColumn = std::min(firstColumn, m_dirtyColumnBegin[row]);
+				endColumn = std::max(endColumn, m_dirtyColumnEnd[row]);
 
-	//If the tile is not on the top edge of the map...
-	if (tileIndex / (size_t)m_mapWidth != 0)
-		neighbors[2] = (tileIndex - (size_t)m_mapWidth);//Add the top neighbor.
+				const size_t rowStart = (size_t)row * m_mapWidth;
+				ApplyBiomePalette(rowStart + m_dirtyColumnBegin[row], rowStart + m_dirtyColumnEnd[row]);
+			}
 
-	//If the tile is not on the bottom edge of the map...
-	if (tileIndex / (size_t)m_mapWidth != ((size_t)m_mapHeight - 1))
-		neighbors[3] = (tileIndex + (size_t)m_mapWidth); //Add the bottom neighbor.
+			graphics->UpdateTexturePixels(m_pTexture.get(), m_tiles, pitch,
+				{ (int)firstColumn, (int)firstRow, (int)(endColumn - firstColumn), (int)(row - firstRow) });
+		}
+	}
 
-	return neighbors;
+	ClearDirtyTiles();
+	graphics->DrawTexture(m_pTexture.get(), 0, 0, 0, 0);
 }
+#endif
 
 std::vector<size_t> TileMap::GetTilesInArea(Exelius::Rectangle area)
 {
@@ -92,6 +182,62 @@ std::vector<size_t> TileMap::GetTilesOfColorInArea(Exelius::Rectangle area, Exel
 	return tiles;
 }
 
+std::vector<size_t> TileMap::GetTilesOfBiomeInArea(Exelius::Rectangle area, BiomeId biome) const
+{
+	std::vector<size_t> tiles;
+	for (int x = area.x; x < area.x + area.w; x += m_tileWidth)
+	{
+		for (int y = area.y; y < area.y + area.h; y += m_tileHeight)
+		{
+			const size_t tileIndex = GetTileIndex({ (float)x,(float)y });
+			if (IsInBounds(tileIndex) && m_biomes[tileIndex] == biome)
+				tiles.emplace_back(tileIndex);
+		}
+	}
+	return tiles;
+}
+
+void TileMap::TrackBiomeCounts(BiomeId biome)
+{
+	if (m_biomeCounts[(size_t)biome].GetWidth() > 0)
+		return;
+
+	// Only this biome is built now, the others are still current unless the whole plane is stale.
+	const std::vector<BiomeId>& biomes = m_biomes;
+	m_biomeCounts[(size_t)biome].Build(m_mapWidth, m_mapHeight, [&biomes, biome](size_t i) { return biomes[i] == biome; });
+	m_isCountingBiomes = true;
+}
+
+size_t TileMap::CountBiomeInArea(Exelius::Rectangle area, BiomeId biome) const
+{
+	// The same tiles GetTilesOfBiomeInArea visits: one per tile step from the area's corner.
+	const int columnCount = (area.w + (int)m_tileWidth - 1) / (int)m_tileWidth;
+	const int rowCount = (area.h + (int)m_tileHeight - 1) / (int)m_tileHeight;
+	const int firstColumn = (area.x >= 0) ? area.x / (int)m_tileWidth : -((-area.x + (int)m_tileWidth - 1) / (int)m_tileWidth);
+	const int firstRow = (area.y >= 0) ? area.y / (int)m_tileHeight : -((-area.y + (int)m_tileHeight - 1) / (int)m_tileHeight);
+
+	const size_t left = (size_t)std::clamp(firstColumn, 0, (int)m_mapWidth);
+	const size_t top = (size_t)std::clamp(firstRow, 0, (int)m_mapHeight);
+	const size_t right = (size_t)std::clamp(firstColumn + columnCount, 0, (int)m_mapWidth);
+	const size_t bottom = (size_t)std::clamp(firstRow + rowCount, 0, (int)m_mapHeight);
+
+	const Exelius::FenwickGrid& counts = m_biomeCounts[(size_t)biome];
+	if (counts.GetWidth() > 0)
+	{
+		RebuildBiomeCounts();
+		return counts.GetCount(left, top, right, bottom);
+	}
+
+	size_t count = 0;
+	for (size_t row = top; row < bottom; ++row)
+	{
+		const BiomeId* pRow = m_biomes.data() + row * (size_t)m_mapWidth;
+		for (size_t column = left; column < right; ++column)
+			count += (pRow[column] == biome) ? 1 : 0;
+	}
+	return count;
+}
+
 size_t TileMap::GetTileIndex(Exelius::Vector2f tilePos) const
 {
 	return ((size_t)(tilePos.y / (size_t)m_tileHeight) * (size_t)m_mapWidth + ((size_t)tilePos.x / (size_t)m_tileWidth));
@@ -107,8 +253,12 @@ Exelius::Vector2f TileMap::GetTilePosition(size_t tileIndex) const
 
 void TileMap::SetTileColor(size_t tileIndex, Exelius::Color newColor)
 {
-	if (IsInBounds(tileIndex))
-		m_tiles[tileIndex] = newColor.GetHex();
+	if (!IsInBounds(tileIndex))
+		return;
+
+	// Pixel maps upload their colors themselves, RenderMap never sees them.
+	assert(!m_pTexture && "SetTileColor on a map RenderMap draws, its biome colors would paint over it.");
+	m_tiles[tileIndex] = newColor.GetHex();
 }
 
 void TileMap::SetTileColor(Exelius::Vector2f tilePosition, Exelius::Color newColor)
@@ -116,6 +266,55 @@ void TileMap::SetTileColor(Exelius::Vector2f tilePosition, Exelius::Color newCol
 	SetTileColor(GetTileIndex(tilePosition), newColor);
 }
 
+void TileMap::UpdateBiomeCounts(size_t tileIndex, BiomeId biome)
+{
+	// Stale counts are rebuilt from the plane anyway.
+	const BiomeId oldBiome = m_biomes[tileIndex];
+	if (m_areBiomeCountsStale || oldBiome == biome)
+		return;
+
+	const size_t column = tileIndex % (size_t)m_mapWidth;
+	const size_t row = tileIndex / (size_t)m_mapWidth;
+
+	Exelius::FenwickGrid& oldCounts = m_biomeCounts[(size_t)oldBiome];
+	if (oldCounts.GetWidth() > 0)
+		oldCounts.Add(column, row, -1);
+
+	Exelius::FenwickGrid& newCounts = m_biomeCounts[(size_t)biome];
+	if (newCounts.GetWidth() > 0)
+		newCounts.Add(column, row, 1);
+}
+
+void TileMap::RebuildBiomeCounts() const
+{
+	if (!m_areBiomeCountsStale)
+		return;
+
+	const std::vector<BiomeId>& biomes = m_biomes;
+	for (size_t biome = 0; biome < m_biomeCounts.size(); ++biome)
+	{
+		if (m_biomeCounts[biome].GetWidth() == 0)
+			continue;
+
+		m_biomeCounts[biome].Build(m_mapWidth, m_mapHeight, [&biomes, biome](size_t i) { return biomes[i] == (BiomeId)biome; });
+	}
+
+	m_areBiomeCountsStale = false;
+}
+
+void TileMap::ClearDirtyTiles()
+{
+	for (unsigned int row = m_firstDirtyRow; row < m_endDirtyRow; ++row)
+	{
+		m_dirtyColumnBegin[row] = 0;
+		m_dirtyColumnEnd[row] = 0;
+	}
+
+	m_firstDirtyRow = m_mapHeight;
+	m_endDirtyRow = 0;
+	m_isAllDirty = false;
+}
+
 bool TileMap::IsInBounds(size_t indexToCheck) const
 {
 	if (indexToCheck >= 0 && indexToCheck < m_tiles.size())
@@ -1,31 +1,153 @@
 #pragma once
+#include "World/GenertionSettings/BiomeId.h"
+
 #include <Managers/Graphics.h>
 #include <Utilities/Vector2.h>
 #include <Utilities/Color.h>
+#include <Utilities/GridNeighborhood.h>
+#include <Utilities/Math/FenwickGrid.h>
 
+#include <algorithm>
+#include <memory>
+#include <tuple>
 #include <vector>
 
+/// <summary>
+/// Per tile values a TileMap can keep next to its biomes, each in a plane of its own.
+///		Height, Tempurature, Moisture (float): the values WorldGenerator classified the tile's biome from.
+///		With height octave culling, ocean, reef and mountain tiles only get a partial height (see
+///		WorldGenerator::SetHeightOctaveCulling).
+///		FireState (uint8_t): fire ticks a burning tile has left, 0 when it isn't burning. Kept by FireGenerator.
+/// </summary>
+enum class TilePlane : uint8_t
+{
+	kHeight,
+	kTempurature,
+	kMoisture,
+	kFireState,
+
+	kCount
+};
+
+/// <summary>
+/// The value type and name of every TilePlane.
+/// </summary>
+template <TilePlane kPlane> struct TilePlaneTraits;
+template <> struct TilePlaneTraits<TilePlane::kHeight> { using Value = float; static constexpr const char* kName = "Height"; };
+template <> struct TilePlaneTraits<TilePlane::kTempurature> { using Value = float; static constexpr const char* kName = "Tempurature"; };
+template <> struct TilePlaneTraits<TilePlane::kMoisture> { using Value = float; static constexpr const char* kName = "Moisture"; };
+template <> struct TilePlaneTraits<TilePlane::kFireState> { using Value = uint8_t; static constexpr const char* kName = "FireState"; };
+
+/// <summary>
+/// A grid of tiles with two planes:
+///		Biomes: one BiomeId byte per tile, the state every generator reads and writes.
+///		Colors: one RGBA color per tile, what gets uploaded. RenderMap fills it from the biome plane
+///		through kBiomePalette. Maps that are only ever pixels (clouds) set their colors directly, and
+///		upload GetTiles themselves. A map is one or the other: RenderMap would paint over set colors.
+///
+/// Tile indices are always row * mapWidth + column, and both planes are stored row major, the order the
+/// colors are uploaded in.
+///
+/// A map can also keep TilePlanes, row major, one vector per plane. A plane is only allocated once
+/// something adds it, and is kept (and reused by every regeneration) from then on.
+/// </summary>
 class TileMap
 {
 	static constexpr uint32_t kDefaultTileColor = Exelius::Colors::White.GetHex();
+	static constexpr BiomeId kDefaultTileBiome = BiomeId::kOcean;
 	std::vector<uint32_t> m_tiles;
+	std::vector<BiomeId> m_biomes;
+
 	unsigned int m_mapWidth;
 	unsigned int m_mapHeight;
 	unsigned int m_tileWidth;
 	unsigned int m_tileHeight;
+
+	// Per biome tile counts for CountBiomeInArea, empty for biomes that aren't tracked (see TrackBiomeCounts).
+	// SetTileBiome keeps them up to date. EditBiomes and SetBiomeRow mark them stale, and
+	// they are rebuilt on the next count.
+	mutable std::vector<Exelius::FenwickGrid> m_biomeCounts;
+	mutable bool m_areBiomeCountsStale;
+	bool m_isCountingBiomes;
+
+	// The texture RenderMap draws. Made on the first render, after that only changed tiles are uploaded.
+	std::shared_ptr<Exelius::ITexture> m_pTexture;
+
+	// Tiles changed since the last render: columns [m_dirtyColumnBegin[row], m_dirtyColumnEnd[row]) of
+	// every row in [m_firstDirtyRow, m_endDirtyRow). Begin == end on a clean row. m_isAllDirty covers
+	// whole-map writes, which don't mark rows.
+	std::vector<unsigned int> m_dirtyColumnBegin;
+	std::vector<unsigned int> m_dirtyColumnEnd;
+	unsigned int m_firstDirtyRow;
+	unsigned int m_endDirtyRow;
+	bool m_isAllDirty;
+
+	// One vector per TilePlane, in TilePlane order. Empty until the plane is added.
+	std::tuple<std::vector<float>, std::vector<float>, std::vector<float>, std::vector<uint8_t>> m_planes;
+	static_assert(std::tuple_size_v<decltype(m_planes)> == (size_t)TilePlane::kCount, "Every TilePlane needs a vector in m_planes.");
+
 public:
+	template <TilePlane kPlane>
+	using PlaneValue = typename TilePlaneTraits<kPlane>::Value;
+
 	TileMap(unsigned int mapWidth, unsigned int mapHeight);
 
-	void RenderMap() const;
+	/// <summary>
+	/// A map with a given tile size that is never drawn, for tools and benchmarks that run without a window.
+	/// </summary>
+	TileMap(unsigned int mapWidth, unsigned int mapHeight, unsigned int tileWidth, unsigned int tileHeight);
+
+	/// <summary>
+	/// Color the tiles that changed since the last render from their biomes, upload them and draw the map.
+	/// The texture is kept between renders, a frame where nothing changed uploads nothing. Only for maps
+	/// colored from their biomes, see SetTileColor.
+	/// </summary>
+	void RenderMap();
 	void ResetMap();
 
-	std::vector<size_t> GetTileNeighbors(size_t tileIndex) const;
+	/// <summary>
+	/// The tiles left, right, above and below a tile, in that order. Tiles past the edge of the map are left
+	/// out. Doesn't allocate.
+	/// </summary>
+	Exelius::GridNeighbors4 GetTileNeighbors(size_t tileIndex) const { return Exelius::GetNeighbors4(tileIndex, m_mapWidth, m_mapHeight); }
+
+	/// <summary>
+	/// The (up to) 8 tiles around a tile, row by row. Doesn't allocate.
+	/// </summary>
+	Exelius::GridNeighbors8 GetTileNeighbors8(size_t tileIndex) const { return Exelius::GetNeighbors8(tileIndex, m_mapWidth, m_mapHeight); }
+
+	/// <summary>
+	/// Every tile of columns [firstColumn, endColumn) of rows [firstRow, endRow) with its neighbours on the
+	/// biome plane, row by row.
+	/// </summary>
+	Exelius::GridStencilRange<BiomeId> GetBiomeStencils(size_t firstRow, size_t endRow, size_t firstColumn, size_t endColumn) const
+	{
+		return Exelius::GridStencilRange<BiomeId>(m_biomes.data(), m_mapWidth, m_mapHeight, firstRow, endRow, firstColumn, endColumn);
+	}
+
 	std::vector<size_t> GetTilesInArea(Exelius::Rectangle area);
 	std::vector<size_t> GetTilesOfColorInArea(Exelius::Rectangle area, Exelius::Color color);
+	std::vector<size_t> GetTilesOfBiomeInArea(Exelius::Rectangle area, BiomeId biome) const;
+
+	/// <summary>
+	/// Keep tile counts of a biome, so CountBiomeInArea answers for it in O(log(width) * log(height))
+	/// instead of visiting the area. Costs 4 bytes per tile per tracked biome.
+	/// </summary>
+	void TrackBiomeCounts(BiomeId biome);
+
+	/// <summary>
+	/// The number of tiles of a biome in an area (in pixels, like GetTilesOfBiomeInArea). Parts of the area
+	/// off the map count nothing.
+	/// </summary>
+	size_t CountBiomeInArea(Exelius::Rectangle area, BiomeId biome) const;
 
 	Exelius::Vector2f GetTilePosition(size_t tileIndex) const;
 	size_t GetTileIndex(Exelius::Vector2f position) const;
 	
+	/// <summary>
+	/// Set a tile's color, on maps that are only pixels. RenderMap colors from the biomes and would paint
+	/// over it, so this asserts once the map has been rendered.
+	/// </summary>
 	void SetTileColor(size_t tileIndex, Exelius::Color newColor);
 	void SetTileColor(Exelius::Vector2f tilePosition, Exelius::Color newColor);
 	uint32_t GetTileColor(Exelius::Vector2f tilePosition) { return m_tiles[GetTileIndex(tilePosition)]; }
@@ -33,6 +155,76 @@ public:
 
 	const std::vector<uint32_t>& GetTiles() const { return m_tiles; }
 
+	void SetTileBiome(size_t tileIndex, BiomeId biome)
+	{
+		if (m_isCountingBiomes)
+			UpdateBiomeCounts(tileIndex, biome);
+		m_biomes[tileIndex] = biome;
+		MarkTileDirty(tileIndex);
+	}
+	BiomeId GetTileBiome(size_t tileIndex) const { return m_biomes[tileIndex]; }
+
+	/// <summary>
+	/// Copy a row of mapWidth biomes in, and mark it for the next render.
+	/// </summary>
+	void SetBiomeRow(unsigned int row, const BiomeId* pBiomes);
+
+	/// <summary>
+	/// Allocate a plane, mapWidth * mapHeight zeroed values. Adding a plane the map already has keeps it as it is.
+	/// </summary>
+	/// <returns>The plane.</returns>
+	template <TilePlane kPlane>
+	std::vector<PlaneValue<kPlane>>& AddPlane()
+	{
+		std::vector<PlaneValue<kPlane>>& plane = std::get<(size_t)kPlane>(m_planes);
+		if (plane.empty())
+			plane.resize((size_t)m_mapWidth * (size_t)m_mapHeight, PlaneValue<kPlane>());
+		return plane;
+	}
+
+	template <TilePlane kPlane>
+	bool HasPlane() const { return !std::get<(size_t)kPlane>(m_planes).empty(); }
+
+	/// <summary>
+	/// A whole plane, indexable by tile index. Empty if the plane was never added.
+	/// </summary>
+	template <TilePlane kPlane>
+	const std::vector<PlaneValue<kPlane>>& GetPlane() const { return std::get<(size_t)kPlane>(m_planes); }
+
+	template <TilePlane kPlane>
+	std::vector<PlaneValue<kPlane>>& GetPlane() { return std::get<(size_t)kPlane>(m_planes); }
+
+	/// <summary>
+	/// One tile of a plane. The plane has to have been added.
+	/// </summary>
+	template <TilePlane kPlane>
+	PlaneValue<kPlane> GetTileValue(size_t tileIndex) const { return std::get<(size_t)kPlane>(m_planes)[tileIndex]; }
+
+	template <TilePlane kPlane>
+	void SetTileValue(size_t tileIndex, PlaneValue<kPlane> value) { std::get<(size_t)kPlane>(m_planes)[tileIndex] = value; }
+
+	/// <summary>
+	/// The biome plane, indexable by tile index.
+	/// </summary>
+	const std::vector<BiomeId>& GetBiomes() const { return m_biomes; }
+
+	/// <summary>
+	/// Write access for whole-map passes. The size must stay mapWidth * mapHeight. Marks every
+	/// tile dirty, and tracked biome counts are rebuilt the next time they are asked for, so read through
+	/// GetBiomes instead.
+	/// </summary>
+	std::vector<BiomeId>& EditBiomes()
+	{
+		m_areBiomeCountsStale = true;
+		m_isAllDirty = true;
+		return m_biomes;
+	}
+
+	/// <summary>
+	/// Set the color of every tile from its biome.
+	/// </summary>
+	void ApplyBiomePalette();
+
 	unsigned int GetMapWidth() const { return m_mapWidth; }
 	unsigned int GetMapHeight() const { return m_mapHeight; }
 	unsigned int GetTileWidth() const { return m_tileWidth; }
@@ -40,4 +232,50 @@ public:
 
 private:
 	bool IsInBounds(size_t indexToCheck) const;
+
+	/// <summary>
+	/// Color tiles [firstTile, endTile) from their biomes.
+	/// </summary>
+	void ApplyBiomePalette(size_t firstTile, size_t endTile);
+
+	/// <summary>
+	/// Add a tile to the area RenderMap uploads.
+	/// </summary>
+	void MarkTileDirty(size_t tileIndex)
+	{
+		if (m_isAllDirty)
+			return;
+
+		const unsigned int row = (unsigned int)(tileIndex / m_mapWidth);
+		const unsigned int column = (unsigned int)(tileIndex - (size_t)row * m_mapWidth);
+
+		if (m_dirtyColumnBegin[row] == m_dirtyColumnEnd[row])
+		{
+			m_dirtyColumnBegin[row] = column;
+			m_dirtyColumnEnd[row] = column + 1;
+		}
+		else
+		{
+			m_dirtyColumnBegin[row] = std::min(m_dirtyColumnBegin[row], column);
+			m_dirtyColumnEnd[row] = std::max(m_dirtyColumnEnd[row], column + 1);
+		}
+
+		m_firstDirtyRow = std::min(m_firstDirtyRow, row);
+		m_endDirtyRow = std::max(m_endDirtyRow, row + 1);
+	}
+
+	/// <summary>
+	/// Forget every changed tile, after a render.
+	/// </summary>
+	void ClearDirtyTiles();
+
+	/// <summary>
+	/// Move a tile from its current biome's count to the count of biome.
+	/// </summary>
+	void UpdateBiomeCounts(size_t tileIndex, BiomeId biome);
+
+	/// <summary>
+	/// Refill every tracked biome's counts from the biome plane, if they are stale.
+	/// </summary>
+	void RebuildBiomeCounts() const;
 };
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "ChunkedWorld.h"
+
+#ifndef EXELIUS_HEADLESS
+#include <ApplicationLayer.h>
+#endif
+
+#include <Utilities/JobSystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+template <class NoiseBackend>
+ChunkedWorld<NoiseBackend>::ChunkedWorld(unsigned long long seed, unsigned int widthInChunks, unsigned int heightInChunks, size_t memoryBudget)
+	: m_generator(seed)
+	, m_isStreaming(false)
+	, m_isChunkDone(false)
+	, m_streamingChunkX(0)
+	, m_streamingChunkY(0)
+	, m_streamedSeconds(0.0)
+	, m_widthInChunks(widthInChunks)
+	, m_heightInChunks(heightInChunks)
+	, m_memoryBudget(memoryBudget)
+	, m_firstViewChunkX(0)
+	, m_firstViewChunkY(0)
+	, m_endViewChunkX(0)
+	, m_endViewChunkY(0)
+	, m_numMissingChunks(0)
+	, m_numGeneratedChunks(0)
+	, m_generationSeconds(0.0)
+{
+	//
+}
+
+template <class NoiseBackend>
+ChunkedWorld<NoiseBackend>::~ChunkedWorld()
+{
+	while (m_isStreaming && !m_isChunkDone.load(std::memory_order_acquire))
+	{
+		std::this_thread::yield();
+	}
+}
+
+template <class NoiseBackend>
+void ChunkedWorld<NoiseBackend>::Update(int viewColumn, int viewRow, unsigned int viewWidth, unsigned int viewHeight, unsigned int prefetchChunks)
+{
+	if (m_isStreaming && m_isChunkDone.load(std::memory_order_acquire))
+		TakeStreamedChunk();
+
+	// The part of the view inside the world, in tiles.
+	const long long worldWidth = (long long)GetWorldWidth();
+	const long long worldHeight = (long long)GetWorldHeight();
+	const long long left = std::clamp((long long)viewColumn, 0LL, worldWidth);
+	const long long top = std::clamp((long long)viewRow, 0LL, worldHeight);
+	const long long right = std::clamp((long long)viewColumn + (long long)viewWidth, 0LL, worldWidth);
+	const long long bottom = std::clamp((long long)viewRow + (long long)viewHeight, 0LL, worldHeight);
+
+	if (right <= left || bottom <= top)
+	{
+		m_firstViewChunkX = m_endViewChunkX = 0;
+		m_firstViewChunkY = m_endViewChunkY = 0;
+		m_numMissingChunks = 0;
+		return;
+	}
+
+	m_firstViewChunkX = (unsigned int)(left / kChunkSize);
+	m_firstViewChunkY = (unsigned int)(top / kChunkSize);
+	m_endViewChunkX = (unsigned int)((right + kChunkSize - 1) / kChunkSize);
+	m_endViewChunkY = (unsigned int)((bottom + kChunkSize - 1) / kChunkSize);
+
+	const unsigned int firstChunkX = (m_firstViewChunkX > prefetchChunks) ? m_firstViewChunkX - prefetchChunks : 0;
+	const unsigned int firstChunkY = (m_firstViewChunkY > prefetchChunks) ? m_firstViewChunkY - prefetchChunks : 0;
+	const unsigned int endChunkX = std::min(m_endViewChunkX + prefetchChunks, m_widthInChunks);
+	const unsigned int endChunkY = std::min(m_endViewChunkY + prefetchChunks, m_heightInChunks);
+
+	// Closest to the middle of the view first.
+	struct ChunkDistance
+	{
+		long long m_distanceSquared;
+		unsigned int m_chunkX;
+		unsigned int m_chunkY;
+	};
+
+	const long long viewCenterX = (left + right) / 2;
+	const long long viewCenterY = (top + bottom) / 2;
+
+	std::vector<ChunkDistance> chunks;
+	chunks.reserve((size_t)(endChunkX - firstChunkX) * (endChunkY - firstChunkY));
+	for (unsigned int chunkY = firstChunkY; chunkY < endChunkY; ++chunkY)
+	{
+		for (unsigned int chunkX = firstChunkX; chunkX < endChunkX; ++chunkX)
+		{
+			const long long offsetX = (long long)chunkX * kChunkSize + kChunkSize / 2 - viewCenterX;
+			const long long offsetY = (long long)chunkY * kChunkSize + kChunkSize / 2 - viewCenterY;
+			chunks.push_back({ offsetX * offsetX + offsetY * offsetY, chunkX, chunkY });
+		}
+	}
+
+	std::sort(chunks.begin(), chunks.end(), [](const ChunkDistance& a, const ChunkDistance& b)
+	{
+		return a.m_distanceSquared < b.m_distanceSquared;
+	});
+
+	size_t numCached = 0;
+	const ChunkDistance* pClosestMissing = nullptr;
+	for (const ChunkDistance& chunk : chunks)
+	{
+		if (TouchChunk(chunk.m_chunkX, chunk.m_chunkY))
+			++numCached;
+		else if (!pClosestMissing)
+			pClosestMissing = &chunk;
+	}
+
+	m_numMissingChunks = chunks.size() - numCached;
+	if (pClosestMissing && !m_isStreaming)
+		StreamChunk(pClosestMissing->m_chunkX, pClosestMissing->m_chunkY);
+
+	// Every cached chunk around the view was just used, so they are the front of m_recentChunks.
+	TrimToBudget(numCached);
+}
+
+template <class NoiseBackend>
+const TileMap* ChunkedWorld<NoiseBackend>::FindChunk(unsigned int chunkX, unsigned int chunkY) const
+{
+	const auto found = m_chunks.find(GetChunkKey(chunkX, chunkY));
+	return (found != m_chunks.end()) ? found->second.m_pTiles.get() : nullptr;
+}
+
+#ifndef EXELIUS_HEADLESS
+template <class NoiseBackend>
+void ChunkedWorld<NoiseBackend>::Render(int viewColumn, int viewRow) const
+{
+	auto& graphics = Exelius::IApplicationLayer::GetInstance()->GetGraphicsRef();
+
+	for (unsigned int chunkY = m_firstViewChunkY; chunkY < m_endViewChunkY; ++chunkY)
+	{
+		for (unsigned int chunkX = m_firstViewChunkX; chunkX < m_endViewChunkX; ++chunkX)
+		{
+			const auto found = m_chunks.find(GetChunkKey(chunkX, chunkY));
+			if (found == m_chunks.end())
+				continue;
+
+			const int32_t x = (int32_t)((long long)chunkX * kChunkSize - viewColumn);
+			const int32_t y = (int32_t)((long long)chunkY * kChunkSize - viewRow);
+			graphics->DrawTexture(found->second.m_pTexture.get(), x, y, kChunkSize, kChunkSize);
+		}
+	}
+}
+#endif
+
+template <class NoiseBackend>
+bool ChunkedWorld<NoiseBackend>::TouchChunk(unsigned int chunkX, unsigned int chunkY)
+{
+	auto found = m_chunks.find(GetChunkKey(chunkX, chunkY));
+	if (found == m_chunks.end())
+		return false;
+
+	m_recentChunks.splice(m_recentChunks.begin(), m_recentChunks, found->second.m_lruPosition);
+	return true;
+}
+
+template <class NoiseBackend>
+void ChunkedWorld<NoiseBackend>::TakeStreamedChunk()
+{
+	const uint64_t key = GetChunkKey(m_streamingChunkX, m_streamingChunkY);
+
+	Chunk& chunk = m_chunks[key];
+	chunk.m_pTiles = std::move(m_pStreamedTiles);
+#ifndef EXELIUS_HEADLESS
+	// Textures are made on the thread that draws.
+	auto& graphics = Exelius::IApplicationLayer::GetInstance()->GetGraphicsRef();
+	chunk.m_pTexture = graphics->GetTextureFromPixels(chunk.m_pTiles->GetTiles(), kChunkSize, kChunkSize, kChunkSize * 4);
+#endif
+
+	m_recentChunks.push_front(key);
+	chunk.m_lruPosition = m_recentChunks.begin();
+
+	++m_numGeneratedChunks;
+	m_generationSeconds += m_streamedSeconds;
+
+	m_isStreaming = false;
+	m_isChunkDone.store(false, std::memory_order_relaxed);
+}
+
+template <class NoiseBackend>
+void ChunkedWorld<NoiseBackend>::StreamChunk(unsigned int chunkX, unsigned int chunkY)
+{
+	m_isStreaming = true;
+	m_streamingChunkX = chunkX;
+	m_streamingChunkY = chunkY;
+
+	Exelius::JobSystem::GetInstance().Submit([this, chunkX, chunkY]()
+	{
+		const auto generationStart = std::chrono::steady_clock::now();
+		m_pStreamedTiles = GenerateChunk(chunkX, chunkY);
+		m_streamedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - generationStart).count();
+
+		m_isChunkDone.store(true, std::memory_order_release);
+	});
+}
+
+template <class NoiseBackend>
+std::unique_ptr<TileMap> ChunkedWorld<NoiseBackend>::GenerateChunk(unsigned int chunkX, unsigned int chunkY)
+{
+	// The chunk plus its apron, cut off at the world edge.
+	const unsigned int firstColumn = chunkX * kChunkSize;
+	const unsigned int firstRow = chunkY * kChunkSize;
+	const unsigned int regionColumn = (firstColumn > kChunkApron) ? firstColumn - kChunkApron : 0;
+	const unsigned int regionRow = (firstRow > kChunkApron) ? firstRow - kChunkApron : 0;
+	const unsigned int regionWidth = std::min(firstColumn + kChunkSize + kChunkApron, GetWorldWidth()) - regionColumn;
+	const unsigned int regionHeight = std::min(firstRow + kChunkSize + kChunkApron, GetWorldHeight()) - regionRow;
+
+	if (!m_pRegion || m_pRegion->GetMapWidth() != regionWidth || m_pRegion->GetMapHeight() != regionHeight)
+		m_pRegion = std::make_unique<TileMap>(regionWidth, regionHeight, 1, 1);
+
+	m_generator.GenerateRegion(*m_pRegion, GetWorldWidth(), GetWorldHeight(), regionColumn, regionRow);
+
+	// This constructor doesn't touch the graphics, the texture is made in TakeStreamedChunk.
+	std::unique_ptr<TileMap> pTiles = std::make_unique<TileMap>(kChunkSize, kChunkSize, 1, 1);
+
+	const std::vector<BiomeId>& regionBiomes = m_pRegion->GetBiomes();
+	for (unsigned int row = 0; row < kChunkSize; ++row)
+	{
+		const size_t regionIndex = (size_t)(firstRow - regionRow + row) * regionWidth + (firstColumn - regionColumn);
+		pTiles->SetBiomeRow(row, regionBiomes.data() + regionIndex);
+	}
+
+	// Chunks never change once generated, so they are colored and uploaded once.
+	pTiles->ApplyBiomePalette();
+	return pTiles;
+}
+
+template <class NoiseBackend>
+void ChunkedWorld<NoiseBackend>::TrimToBudget(size_t numKeep)
+{
+	while (m_chunks.size() > numKeep && GetCachedBytes() > m_memoryBudget)
+	{
+		m_chunks.erase(m_recentChunks.back());
+		m_recentChunks.pop_back();
+	}
+}
+
+// The world is only ever built against these backends, so the definitions can stay out of the header.
+template class ChunkedWorld<Exelius::PerlinNoise>;
+template class ChunkedWorld<Exelius::SimplexNoise>;
\ No newline at end of file
@@ -0,0 +1,189 @@
+#pragma once
+#include "World/GenertionSettings/GeneratorConfig.h"
+#include "World/TileMap/TileMap.h"
+#include "World/WorldGeneration/WorldGenerator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+/// <summary>
+/// A world much larger than the screen, generated in kChunkSize x kChunkSize tile chunks as the view gets
+/// close to them.
+///
+/// A chunk only depends on the seed and its chunk coordinate. It is generated with
+/// WorldGenerator::GenerateRegion as a window of the whole world, with kChunkApron extra tiles on every
+/// side that are thrown away afterwards, so flora growth on the chunk's edge sees its real neighbours.
+/// Chunks line up at their seams, and are tile for tile what GenerateWorld makes of the whole world.
+///
+/// Generated chunks are kept in an LRU cache. When the cache holds more than the memory budget, the least
+/// recently used chunks outside the view are dropped, and generated again if the view comes back.
+///
+/// Chunks are streamed: Update never waits for one. It hands the missing chunk closest to the view to a
+/// job system worker (JobSystem::Submit) and picks it up at a later Update, one chunk at a time. Until
+/// then the view has a hole where the chunk goes. The noise keeps its detail per tile however large the
+/// world is, while the island falloff and the latitude stretch over all of it.
+///
+/// Tiles are one unit wide, like the window sized map. Everything except the streamed generation happens
+/// on the thread that calls Update.
+/// </summary>
+template <class NoiseBackend>
+class ChunkedWorld
+{
+public:
+	// Tiles per chunk side.
+	static constexpr unsigned int kChunkSize = 256;
+
+	// Flora growth spreads one tile per iteration, so this many tiles past the chunk are enough.
+	static constexpr unsigned int kChunkApron = (unsigned int)kNumCellularAutomataIterations;
+
+	static constexpr size_t kDefaultMemoryBudget = (size_t)64 * 1024 * 1024;
+
+private:
+	struct Chunk
+	{
+		std::unique_ptr<TileMap> m_pTiles;
+#ifndef EXELIUS_HEADLESS
+		std::shared_ptr<Exelius::ITexture> m_pTexture;
+#endif
+		std::list<uint64_t>::iterator m_lruPosition;
+	};
+
+	// Only used by the chunk being streamed, so never by two threads at once.
+	WorldGenerator<NoiseBackend> m_generator;
+
+	// The window the last chunk was generated in. Reused while the window size stays the same.
+	std::unique_ptr<TileMap> m_pRegion;
+
+	// A chunk was handed to a worker and not picked up yet.
+	bool m_isStreaming;
+
+	// Set by the worker once m_pStreamedTiles and m_streamedSeconds are written.
+	std::atomic<bool> m_isChunkDone;
+
+	unsigned int m_streamingChunkX;
+	unsigned int m_streamingChunkY;
+	std::unique_ptr<TileMap> m_pStreamedTiles;
+	double m_streamedSeconds;
+
+	std::unordered_map<uint64_t, Chunk> m_chunks;
+
+	// Keys of m_chunks, most recently used first.
+	std::list<uint64_t> m_recentChunks;
+
+	unsigned int m_widthInChunks;
+	unsigned int m_heightInChunks;
+	size_t m_memoryBudget;
+
+	// Chunks that overlapped the view at the last Update: [first, end) in chunk coordinates.
+	unsigned int m_firstViewChunkX;
+	unsigned int m_firstViewChunkY;
+	unsigned int m_endViewChunkX;
+	unsigned int m_endViewChunkY;
+
+	// Chunks in the view and its prefetch ring that weren't cached at the last Update.
+	size_t m_numMissingChunks;
+
+	size_t m_numGeneratedChunks;
+	double m_generationSeconds;
+
+public:
+	/// <summary>
+	/// A world of widthInChunks x heightInChunks chunks. Nothing is generated until it is asked for.
+	/// </summary>
+	/// <param name="seed">(unsigned long long) Seed of the world, as WorldGenerator takes it.</param>
+	/// <param name="widthInChunks">(unsigned int) World width in chunks.</param>
+	/// <param name="heightInChunks">(unsigned int) World height in chunks.</param>
+	/// <param name="memoryBudget">(size_t) Bytes the cached chunks may use before old ones are dropped.</param>
+	ChunkedWorld(unsigned long long seed, unsigned int widthInChunks, unsigned int heightInChunks, size_t memoryBudget = kDefaultMemoryBudget);
+
+	/// <summary>
+	/// Waits for the chunk that is being streamed, it uses this world's generator.
+	/// </summary>
+	~ChunkedWorld();
+
+	ChunkedWorld(const ChunkedWorld&) = delete;
+	ChunkedWorld& operator=(const ChunkedWorld&) = delete;
+
+	/// <summary>
+	/// Pick up the chunk that finished streaming, if any. Then, if no chunk is streaming, start on the
+	/// missing chunk closest to the view, out of the ones that overlap it and prefetchChunks chunks around
+	/// it. Last, drop old chunks until the cache fits the budget again. Chunks in the view and its prefetch
+	/// ring are never dropped, even if they don't fit on their own.
+	///
+	/// Call it every frame: each call starts at most one chunk, and doesn't wait for it.
+	/// </summary>
+	/// <param name="viewColumn">(int) Left tile column of the view, may be outside the world.</param>
+	/// <param name="viewRow">(int) Top tile row of the view, may be outside the world.</param>
+	/// <param name="viewWidth">(unsigned int) View width in tiles.</param>
+	/// <param name="viewHeight">(unsigned int) View height in tiles.</param>
+	/// <param name="prefetchChunks">(unsigned int) Chunks around the view that are generated ahead of time.</param>
+	void Update(int viewColumn, int viewRow, unsigned int viewWidth, unsigned int viewHeight, unsigned int prefetchChunks = 1);
+
+	/// <summary>
+	/// The cached chunk at a chunk coordinate, or nullptr while it isn't streamed in.
+	/// </summary>
+	const TileMap* FindChunk(unsigned int chunkX, unsigned int chunkY) const;
+
+	/// <summary>
+	/// Every chunk in the view and its prefetch ring was cached at the last Update.
+	/// </summary>
+	bool IsViewStreamed() const { return m_numMissingChunks == 0; }
+
+#ifndef EXELIUS_HEADLESS
+	/// <summary>
+	/// Draw the cached chunks in the view of the last Update, relative to the view's top left tile.
+	/// </summary>
+	/// <param name="viewColumn">(int) Left tile column of the view, as passed to Update.</param>
+	/// <param name="viewRow">(int) Top tile row of the view, as passed to Update.</param>
+	void Render(int viewColumn, int viewRow) const;
+#endif
+
+	bool IsChunkCached(unsigned int chunkX, unsigned int chunkY) const { return m_chunks.count(GetChunkKey(chunkX, chunkY)) != 0; }
+
+	unsigned int GetWorldWidth() const { return m_widthInChunks * kChunkSize; }
+	unsigned int GetWorldHeight() const { return m_heightInChunks * kChunkSize; }
+
+	size_t GetCachedChunkCount() const { return m_chunks.size(); }
+	size_t GetCachedBytes() const { return m_chunks.size() * GetChunkBytes(); }
+
+	/// <summary>
+	/// Chunks generated so far, including ones generated again after being dropped, and the time the
+	/// workers spent on them.
+	/// </summary>
+	size_t GetGeneratedChunkCount() const { return m_numGeneratedChunks; }
+	double GetGenerationSeconds() const { return m_generationSeconds; }
+
+	/// <summary>
+	/// Memory a cached chunk takes: its biome and color planes.
+	/// </summary>
+	static constexpr size_t GetChunkBytes() { return (size_t)kChunkSize * kChunkSize * (sizeof(BiomeId) + sizeof(uint32_t)); }
+
+private:
+	static uint64_t GetChunkKey(unsigned int chunkX, unsigned int chunkY) { return ((uint64_t)chunkY << 32) | chunkX; }
+
+	/// <summary>
+	/// Move a cached chunk to the front of m_recentChunks.
+	/// </summary>
+	/// <returns>(bool) False if the chunk isn't cached.</returns>
+	bool TouchChunk(unsigned int chunkX, unsigned int chunkY);
+
+	/// <summary>
+	/// Cache the chunk a worker finished, at the front of m_recentChunks.
+	/// </summary>
+	void TakeStreamedChunk();
+
+	void StreamChunk(unsigned int chunkX, unsigned int chunkY);
+
+	/// <summary>
+	/// Runs on a worker, with m_generator and m_pRegion to itself while m_isStreaming is set.
+	/// </summary>
+	std::unique_ptr<TileMap> GenerateChunk(unsigned int chunkX, unsigned int chunkY);
+
+	/// <summary>
+	/// Drop the least recently used chunks while over budget, keeping the numKeep most recently used.
+	/// </summary>
+	void TrimToBudget(size_t numKeep);
+};
\ No newline at end of file
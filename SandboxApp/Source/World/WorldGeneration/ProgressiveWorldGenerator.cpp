@@ -0,0 +1,213 @@
+#include "ProgressiveWorldGenerator.h"
+
+#include <Utilities/JobSystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Copy a level's plane into the same plane of a full resolution map, every level tile covering step x step
+/// tiles. Skipped if either map doesn't keep the plane.
+/// </summary>
+template <TilePlane kPlane>
+static void CopyLevelPlane(const TileMap& levelMap, unsigned int step, TileMap& map)
+{
+	if (!levelMap.HasPlane<kPlane>() || !map.HasPlane<kPlane>())
+		return;
+
+	const auto& levelValues = levelMap.GetPlane<kPlane>();
+	auto& values = map.GetPlane<kPlane>();
+
+	if (step == 1)
+	{
+		std::copy(levelValues.begin(), levelValues.end(), values.begin());
+		return;
+	}
+
+	const unsigned int levelWidth = levelMap.GetMapWidth();
+	const unsigned int width = map.GetMapWidth();
+	for (unsigned int row = 0; row < map.GetMapHeight(); ++row)
+	{
+		const auto* pLevelRow = levelValues.data() + (size_t)(row / step) * levelWidth;
+		auto* pRow = values.data() + (size_t)row * width;
+
+		for (unsigned int column = 0; column < width; column += step)
+		{
+			std::fill_n(pRow + column, std::min(step, width - column), pLevelRow[column / step]);
+		}
+	}
+}
+
+template <class NoiseBackend>
+ProgressiveWorldGenerator<NoiseBackend>::ProgressiveWorldGenerator(unsigned long long seed)
+	: m_generator(seed)
+	, m_levelSeconds()
+	, m_worldWidth(0)
+	, m_worldHeight(0)
+	, m_isRefining(false)
+	, m_isRefineDone(false)
+	, m_numFinishedLevels(0)
+	, m_cancel(false)
+	, m_numAppliedLevels(0)
+{
+	//
+}
+
+template <class NoiseBackend>
+ProgressiveWorldGenerator<NoiseBackend>::~ProgressiveWorldGenerator()
+{
+	Stop();
+}
+
+template <class NoiseBackend>
+void ProgressiveWorldGenerator<NoiseBackend>::ResetGenerator()
+{
+	Stop();
+	m_generator.ResetGenerator();
+}
+
+template <class NoiseBackend>
+void ProgressiveWorldGenerator<NoiseBackend>::Start(unsigned int worldWidth, unsigned int worldHeight, bool keepClimatePlanes)
+{
+	Stop();
+
+	m_worldWidth = worldWidth;
+	m_worldHeight = worldHeight;
+	m_numFinishedLevels.store(0, std::memory_order_relaxed);
+	m_numAppliedLevels = 0;
+	m_cancel.store(false, std::memory_order_relaxed);
+
+	for (size_t level = 0; level < kNumLevels; ++level)
+	{
+		const unsigned int step = kLevelSteps[level];
+		const unsigned int levelWidth = (worldWidth + step - 1) / step;
+		const unsigned int levelHeight = (worldHeight + step - 1) / step;
+
+		const TileMap* pLevelMap = m_pLevels[level].get();
+		if (pLevelMap && pLevelMap->GetMapWidth() == levelWidth && pLevelMap->GetMapHeight() == levelHeight
+			&& pLevelMap->HasPlane<TilePlane::kHeight>() == keepClimatePlanes)
+		{
+			continue;
+		}
+
+		m_pLevels[level] = std::make_unique<TileMap>(levelWidth, levelHeight, 1, 1);
+		if (keepClimatePlanes)
+		{
+			TileMap& levelMap = *m_pLevels[level];
+			levelMap.AddPlane<TilePlane::kHeight>();
+			levelMap.AddPlane<TilePlane::kTempurature>();
+			levelMap.AddPlane<TilePlane::kMoisture>();
+		}
+	}
+
+	// The preview is cheap enough to make right here, so there is something to show on the next frame.
+	GenerateLevel(0);
+
+	m_isRefining = true;
+	m_isRefineDone.store(false, std::memory_order_relaxed);
+
+	Exelius::JobSystem::GetInstance().Submit([this]()
+	{
+		for (size_t level = 1; level < kNumLevels; ++level)
+		{
+			if (m_cancel.load(std::memory_order_relaxed))
+				break;
+
+			GenerateLevel(level);
+		}
+
+		m_isRefineDone.store(true, std::memory_order_release);
+	});
+}
+
+template <class NoiseBackend>
+void ProgressiveWorldGenerator<NoiseBackend>::Stop()
+{
+	if (!m_isRefining)
+		return;
+
+	m_cancel.store(true, std::memory_order_relaxed);
+	WaitForRefine();
+}
+
+template <class NoiseBackend>
+bool ProgressiveWorldGenerator<NoiseBackend>::UpdateMap(TileMap& map)
+{
+	const size_t numFinishedLevels = m_numFinishedLevels.load(std::memory_order_acquire);
+	if (numFinishedLevels <= m_numAppliedLevels)
+		return false;
+
+	const size_t level = numFinishedLevels - 1;
+	CopyLevel(*m_pLevels[level], kLevelSteps[level], map);
+	m_numAppliedLevels = numFinishedLevels;
+
+	// The refine task is done with its last level, so this only waits for it to return.
+	if (IsFinished() && m_isRefining)
+		WaitForRefine();
+
+	return true;
+}
+
+template <class NoiseBackend>
+void ProgressiveWorldGenerator<NoiseBackend>::GenerateLevel(size_t level)
+{
+	const auto levelStart = std::chrono::steady_clock::now();
+	m_generator.GenerateRegion(*m_pLevels[level], m_worldWidth, m_worldHeight, 0, 0, kLevelSteps[level]);
+	m_levelSeconds[level] = std::chrono::duration<double>(std::chrono::steady_clock::now() - levelStart).count();
+
+	m_numFinishedLevels.store(level + 1, std::memory_order_release);
+}
+
+template <class NoiseBackend>
+void ProgressiveWorldGenerator<NoiseBackend>::WaitForRefine()
+{
+	// The worker running the refine task has the rest of the job system to help with its levels.
+	while (!m_isRefineDone.load(std::memory_order_acquire))
+	{
+		std::this_thread::yield();
+	}
+
+	m_isRefining = false;
+}
+
+template <class NoiseBackend>
+void ProgressiveWorldGenerator<NoiseBackend>::CopyLevel(const TileMap& levelMap, unsigned int step, TileMap& map) const
+{
+	CopyLevelPlane<TilePlane::kHeight>(levelMap, step, map);
+	CopyLevelPlane<TilePlane::kTempurature>(levelMap, step, map);
+	CopyLevelPlane<TilePlane::kMoisture>(levelMap, step, map);
+
+	// Rows go in through SetBiomeRow, which marks them for the next render.
+	const std::vector<BiomeId>& levelBiomes = levelMap.GetBiomes();
+
+	if (step == 1)
+	{
+		for (unsigned int row = 0; row < m_worldHeight; ++row)
+			map.SetBiomeRow(row, levelBiomes.data() + (size_t)row * m_worldWidth);
+		return;
+	}
+
+	const unsigned int levelWidth = levelMap.GetMapWidth();
+	std::vector<BiomeId> upscaledRow(m_worldWidth);
+	for (unsigned int row = 0; row < m_worldHeight; ++row)
+	{
+		const BiomeId* pLevelRow = levelBiomes.data() + (size_t)(row / step) * levelWidth;
+
+		// Every step rows come from the same level row.
+		if (row % step == 0)
+		{
+			for (unsigned int column = 0; column < m_worldWidth; column += step)
+			{
+				std::fill_n(upscaledRow.data() + column, std::min(step, m_worldWidth - column), pLevelRow[column / step]);
+			}
+		}
+
+		map.SetBiomeRow(row, upscaledRow.data());
+	}
+}
+
+// The generator is only ever built against these backends, so the definitions can stay out of the header.
+template class ProgressiveWorldGenerator<Exelius::PerlinNoise>;
+template class ProgressiveWorldGenerator<Exelius::SimplexNoise>;
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+#include "World/TileMap/TileMap.h"
+#include "World/WorldGeneration/WorldGenerator.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/// <summary>
+/// Regenerates a world coarse to fine, so a new world is on screen the frame after it is asked for.
+///
+/// Start generates a 1/8 resolution preview of the world right away (a 64th of the tiles, a few
+/// milliseconds), then a job system worker generates the 1/4, 1/2 and full resolution levels in the
+/// background (JobSystem::Submit), running each one as a ParallelFor from there. Each level
+/// is a WorldGenerator::GenerateRegion of the whole world with a tile step, so every level samples the
+/// same noise and the preview is the final world at a lower resolution. UpdateMap copies the finest level
+/// that is done into the map, scaled up to the world size.
+///
+/// With a single job system thread there is no worker to refine on, and Start generates every level before
+/// it returns.
+/// </summary>
+template <class NoiseBackend>
+class ProgressiveWorldGenerator
+{
+public:
+	// World tiles per level tile, coarsest first. The last level is the full resolution world.
+	static constexpr unsigned int kLevelSteps[] = { 8, 4, 2, 1 };
+	static constexpr size_t kNumLevels = sizeof(kLevelSteps) / sizeof(kLevelSteps[0]);
+
+private:
+	WorldGenerator<NoiseBackend> m_generator;
+
+	// One map per level, ceil(world size / step) tiles. Kept between regenerations of the same world size.
+	std::unique_ptr<TileMap> m_pLevels[kNumLevels];
+	double m_levelSeconds[kNumLevels];
+
+	unsigned int m_worldWidth;
+	unsigned int m_worldHeight;
+
+	// The refine task was submitted and Stop or UpdateMap hasn't seen it finish yet.
+	bool m_isRefining;
+
+	// Set by the refine task when it returns, after its last level or a cancel.
+	std::atomic<bool> m_isRefineDone;
+
+	// Levels [0, m_numFinishedLevels) are generated. Set by the refine task, after the level is written.
+	std::atomic<size_t> m_numFinishedLevels;
+	std::atomic<bool> m_cancel;
+
+	// Levels the last UpdateMap has seen.
+	size_t m_numAppliedLevels;
+
+public:
+	/// <summary>
+	/// seed is passed on to the WorldGenerator.
+	/// </summary>
+	ProgressiveWorldGenerator(unsigned long long seed = 0);
+
+	/// <summary>
+	/// Waits for a running regeneration to stop.
+	/// </summary>
+	~ProgressiveWorldGenerator();
+
+	ProgressiveWorldGenerator(const ProgressiveWorldGenerator&) = delete;
+	ProgressiveWorldGenerator(ProgressiveWorldGenerator&&) = delete;
+	ProgressiveWorldGenerator& operator=(const ProgressiveWorldGenerator&) = delete;
+	ProgressiveWorldGenerator& operator=(ProgressiveWorldGenerator&&) = delete;
+
+	/// <summary>
+	/// The generator every level is made with. Only touch it while no regeneration is running (see Stop).
+	/// </summary>
+	WorldGenerator<NoiseBackend>& GetGenerator() { return m_generator; }
+
+	/// <summary>
+	/// Stop a running regeneration and pick new seeds, like WorldGenerator::ResetGenerator.
+	/// </summary>
+	void ResetGenerator();
+
+	/// <summary>
+	/// Start regenerating a worldWidth x worldHeight world. The coarsest level is generated before this
+	/// returns, the rest in the background. A regeneration that is still running is stopped first.
+	/// </summary>
+	/// <param name="keepClimatePlanes">(bool) Levels keep the Height, Tempurature and Moisture planes too,
+	/// for a map UpdateMap copies them to. Without it levels only have biomes.</param>
+	void Start(unsigned int worldWidth, unsigned int worldHeight, bool keepClimatePlanes = false);
+
+	/// <summary>
+	/// Stop a running regeneration. Waits for the level that is being generated to finish.
+	/// </summary>
+	void Stop();
+
+	/// <summary>
+	/// Copy the finest finished level into map, if it is finer than the last one copied. Levels that were
+	/// finished and replaced between two calls are skipped. map must be the size of the world. The climate
+	/// planes are copied when map and the levels both keep them (see Start).
+	/// </summary>
+	/// <returns>(bool) True if map changed.</returns>
+	bool UpdateMap(TileMap& map);
+
+	/// <summary>
+	/// True once UpdateMap has copied the full resolution level.
+	/// </summary>
+	bool IsFinished() const { return m_numAppliedLevels == kNumLevels; }
+
+	/// <summary>
+	/// Seconds the given level of the last regeneration took to generate, 0 if it isn't finished.
+	/// </summary>
+	double GetLevelSeconds(size_t level) const { return (level < m_numFinishedLevels.load(std::memory_order_acquire)) ? m_levelSeconds[level] : 0.0; }
+
+private:
+	void GenerateLevel(size_t level);
+
+	/// <summary>
+	/// Wait for the refine task to return, and forget it.
+	/// </summary>
+	void WaitForRefine();
+
+	/// <summary>
+	/// Scale a level up into map, one level tile to a step x step block of map tiles.
+	/// </summary>
+	void CopyLevel(const TileMap& levelMap, unsigned int step, TileMap& map) const;
+};
\ No newline at end of file
@@ -1,113 +1,434 @@
 #include "WorldGenerator.h"
 #include "World/GenertionSettings/GeneratorConfig.h"
 
-WorldGenerator::WorldGenerator()
-	: m_mapWidth(0)
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+template <class NoiseBackend>
+WorldGenerator<NoiseBackend>::WorldGenerator(unsigned long long seed)
+	: m_rand(seed, seed)
+	, m_mapWidth(0)
 	, m_mapHeight(0)
+	, m_tileWidth(1)
+	, m_tileHeight(1)
+	, m_worldWidth(0)
+	, m_worldHeight(0)
+	, m_originColumn(0)
+	, m_originRow(0)
+	, m_tileStep(1)
+	, m_cullHeightOctaves(false)
 {
+	// Same order as PipelineStage, a stage's id is the order it was added in.
+	m_pipeline.AddStage("Height", {});
+	m_pipeline.AddStage("Tempurature", { kHeightStage });
+	m_pipeline.AddStage("Moisture", { kHeightStage, kTempuratureStage });
+	m_pipeline.AddStage("Biome", { kHeightStage, kTempuratureStage, kMoistureStage });
+	m_pipeline.AddStage("Salt", { kBiomeStage });
+	m_pipeline.AddStage("Flora", { kSaltStage });
+
 	ResetGenerator();
+}
 
-	//Create all of the worker threads that we will need.
-	m_pThreadPool = new std::thread[kMaxThreads];
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::ResetGenerator()
+{
+	m_heightParameters.SetParameters(kDefaultHeightOctaves, kDefaultHeightInputRange, kDefaultHeightPersistance, (unsigned int)m_rand.Rand());
+	m_moistureParameters.SetParameters(kDefaultMoistureOctaves, kDefaultMoistureInputRange, kDefaultMoisturePersistance, (unsigned int)m_rand.Rand());
+	m_tileRandom = Exelius::TileRandom((unsigned int)m_rand.Rand());
 }
 
-WorldGenerator::~WorldGenerator()
+/// <summary>
+/// Copy one of the generator's planes into a map's plane of the same size, if the map keeps that plane.
+/// </summary>
+template <TilePlane kPlane>
+static void CopyToPlane(const std::vector<TileMap::PlaneValue<kPlane>>& values, TileMap& map)
 {
-	delete[] m_pThreadPool;
+	if (map.HasPlane<kPlane>())
+		std::copy(values.begin(), values.end(), map.GetPlane<kPlane>().begin());
 }
 
-void WorldGenerator::ResetGenerator()
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::GenerateWorld(TileMap& map)
 {
-	m_heightParameters.SetParameters(kDefaultHeightOctaves, kDefaultHeightInputRange, kDefaultHeightPersistance, (unsigned int)m_rand.Rand());
-	m_moistureParameters.SetParameters(kDefaultMoistureOctaves, kDefaultMoistureInputRange, kDefaultMoisturePersistance, (unsigned int)m_rand.Rand());
+	GenerateRegion(map, map.GetMapWidth(), map.GetMapHeight(), 0, 0);
 }
 
-void WorldGenerator::GenerateWorld(TileMap& map)
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::GenerateRegion(TileMap& map, unsigned int worldWidth, unsigned int worldHeight, unsigned int originColumn, unsigned int originRow,
+	unsigned int tileStep)
 {
+	EXELIUS_TRACE_SCOPE("WorldGenerator::GenerateRegion");
+	const auto generationStart = std::chrono::steady_clock::now();
+
 	m_mapWidth = map.GetMapWidth();
 	m_mapHeight = map.GetMapHeight();
+	m_tileWidth = map.GetTileWidth();
+	m_tileHeight = map.GetTileHeight();
+	m_worldWidth = worldWidth;
+	m_worldHeight = worldHeight;
+	m_originColumn = originColumn;
+	m_originRow = originRow;
+	m_tileStep = (tileStep > 0) ? tileStep : 1;
+
+	m_pipeline.Prepare([this](size_t stage, Exelius::StageKey& key)
+	{
+		AddStageParameters(stage, key);
+	});
+
+	// The noise fields see a map whose tiles are m_tileStep world tiles apart. Octaves that are already
+	// cached for these settings are only re-blended. Both fields start their update here, so the height
+	// stage can generate the missing octaves of both in one pass.
+	const float tileWidth = (float)(m_tileWidth * m_tileStep);
+	const float tileHeight = (float)(m_tileHeight * m_tileStep);
+	const unsigned int fieldColumn = m_originColumn / m_tileStep;
+	const unsigned int fieldRow = m_originRow / m_tileStep;
+
+	if (m_pipeline.IsDirty(kHeightStage) && !m_cullHeightOctaves)
+	{
+		m_heightField.BeginUpdate(m_mapWidth, m_mapHeight, tileWidth, tileHeight,
+			kNoiseWorldWidth / kHeightNoiseDivisor, kNoiseWorldHeight / kHeightNoiseDivisor,
+			m_heightParameters.GetInputRange(), m_heightParameters.GetOctaves(), m_heightParameters.GetSeed(), fieldColumn, fieldRow);
+	}
+	if (m_pipeline.IsDirty(kMoistureStage))
+	{
+		m_moistureField.BeginUpdate(m_mapWidth, m_mapHeight, tileWidth, tileHeight,
+			kNoiseWorldWidth, kNoiseWorldHeight,
+			m_moistureParameters.GetInputRange(), m_moistureParameters.GetOctaves(), m_moistureParameters.GetSeed(), fieldColumn, fieldRow);
+	}
 
-	size_t threadStride = (m_mapWidth * m_mapHeight) / (kMaxThreads + 1);
-
-	size_t startIndex = 0;
-	size_t endIndex = threadStride;
+	// The island and the latitude span the whole world, unlike the noise. Only built the first time a world
+	// size is seen, after that these are lookups.
+	m_pHeightFalloff = FalloffTable::Get(m_worldWidth, m_worldHeight, m_tileWidth, m_tileHeight, kHeightNoiseExponent);
+	m_pLatitudeFalloff = FalloffTable::Get(m_worldWidth, m_worldHeight, m_tileWidth, m_tileHeight, kDefaultTempuratureFalloffExponent);
 
-	for (size_t i = 0; i < kMaxThreads; ++i)
+	Exelius::JobSystem& jobSystem = Exelius::JobSystem::GetInstance();
+	m_threadScratch.resize(jobSystem.GetThreadCount());
+	for (ThreadScratch& scratch : m_threadScratch)
 	{
-		m_pThreadPool[i] = std::thread(&WorldGenerator::GenerateWorldThread, this, std::ref(map), startIndex, endIndex);
-		startIndex += threadStride;
-		endIndex += threadStride;
+		scratch.m_saltChanceRow.resize(m_mapWidth);
+		if (m_cullHeightOctaves)
+			scratch.m_falloffRow.resize(m_mapWidth);
 	}
 
-	GenerateWorldThread(map, startIndex, (size_t)m_mapWidth * (size_t)m_mapHeight);
+	m_pipeline.Run([this](size_t stage)
+	{
+		RunStage(stage);
+	});
+
+	for (unsigned int row = 0; row < m_mapHeight; ++row)
+		map.SetBiomeRow(row, m_grownBiomes.data() + (size_t)row * m_mapWidth);
+
+	// Maps that keep the climate planes get the values the biomes were classified from.
+	CopyToPlane<TilePlane::kHeight>(m_heightValues, map);
+	CopyToPlane<TilePlane::kTempurature>(m_tempuratureValues, map);
+	CopyToPlane<TilePlane::kMoisture>(m_moistureValues, map);
+	const auto generationEnd = std::chrono::steady_clock::now();
+
+	m_lastTimings = WorldGenerationTimings();
+	m_lastTimings.m_noiseSeconds = m_pipeline.GetStageSeconds(kHeightStage) + m_pipeline.GetStageSeconds(kMoistureStage);
+	m_lastTimings.m_biomeSeconds = m_pipeline.GetStageSeconds(kTempuratureStage) + m_pipeline.GetStageSeconds(kBiomeStage);
+	m_lastTimings.m_saltSeconds = m_pipeline.GetStageSeconds(kSaltStage);
+	m_lastTimings.m_growFloraSeconds = m_pipeline.GetStageSeconds(kFloraStage);
+	m_lastTimings.m_totalSeconds = std::chrono::duration<double>(generationEnd - generationStart).count();
+}
 
-	//Wait for the threads to complete the read task.
-	for (unsigned int i = 0; i < kMaxThreads; ++i)
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::AddStageParameters(size_t stage, Exelius::StageKey& key) const
+{
+	switch (stage)
 	{
-		m_pThreadPool[i].join();
+	case kHeightStage:
+		// The layout of the map in the world. Every other stage gets it through its inputs.
+		key.Add(m_mapWidth).Add(m_mapHeight).Add(m_tileWidth).Add(m_tileHeight).Add(m_worldWidth).Add(m_worldHeight)
+			.Add(m_originColumn).Add(m_originRow).Add(m_tileStep);
+		key.Add(m_heightParameters.GetOctaves()).Add(m_heightParameters.GetInputRange()).Add(m_heightParameters.GetPersistance())
+			.Add(m_heightParameters.GetSeed()).Add(m_cullHeightOctaves);
+		break;
+
+	case kMoistureStage:
+		key.Add(m_moistureParameters.GetOctaves()).Add(m_moistureParameters.GetInputRange()).Add(m_moistureParameters.GetPersistance())
+			.Add(m_moistureParameters.GetSeed());
+		break;
+
+	case kSaltStage:
+	case kFloraStage:
+		key.Add(m_tileRandom.GetSeed());
+		break;
+
+	default:
+		// Tempurature and biome only depend on their inputs and GeneratorConfig.h.
+		break;
 	}
+}
+
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::RunStage(size_t stage)
+{
+	EXELIUS_TRACE_SCOPE(m_pipeline.GetStageName(stage));
 
-	for (int i = 0; i < kNumCellularAutomataIterations; ++i)
+	switch (stage)
 	{
-		GrowFlora(map);
+	case kHeightStage:		RunHeightStage(); break;
+	case kTempuratureStage:	RunTempuratureStage(); break;
+	case kMoistureStage:	RunMoistureStage(); break;
+	case kBiomeStage:		RunBiomeStage(); break;
+	case kSaltStage:		RunSaltStage(); break;
+	case kFloraStage:		RunFloraStage(); break;
+	default: break;
 	}
 }
 
-void WorldGenerator::GenerateWorldThread(TileMap& map, size_t startIndex, size_t endIndex)
+template <class NoiseBackend>
+template <class Function>
+void WorldGenerator<NoiseBackend>::ForEachRows(size_t stage, size_t rowsPerJob, const Function& function)
 {
-	for (size_t i = startIndex; i < endIndex; ++i)
+	const char* pStageName = m_pipeline.GetStageName(stage);
+
+	Exelius::JobSystem& jobSystem = Exelius::JobSystem::GetInstance();
+	jobSystem.ParallelFor(0, m_mapHeight, rowsPerJob, [this, &jobSystem, &function, pStageName](size_t firstRow, size_t endRow)
+	{
+		EXELIUS_TRACE_SCOPE(pStageName);
+		function(firstRow, endRow, m_threadScratch[jobSystem.GetCurrentThreadIndex()]);
+	});
+}
+
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::RunHeightStage()
+{
+	m_heightValues.resize((size_t)m_mapWidth * m_mapHeight);
+
+	ForEachRows(kHeightStage, kRowsPerJob, [this](size_t firstRow, size_t endRow, ThreadScratch& scratch)
 	{
-		const Exelius::Vector2f gridPoint = map.GetTilePosition(i);
+		for (size_t row = firstRow; row < endRow; ++row)
+		{
+			const size_t rowStartIndex = row * m_mapWidth;
+			float* pHeights = m_heightValues.data() + rowStartIndex;
+
+			GenerateNoiseRow(scratch.m_fieldCache, rowStartIndex, m_mapWidth);
+
+			if (m_cullHeightOctaves)
+				GetCulledHeightNoiseRow(scratch.m_cullerCache, scratch.m_heightCuller, rowStartIndex, m_mapWidth, scratch.m_falloffRow.data(), pHeights);
+			else
+				GetHeightNoiseRow(rowStartIndex, m_mapWidth, pHeights);
+
+			for (size_t i = 0; i < m_mapWidth; ++i)
+			{
+				pHeights[i] = CalculateHeightValue(pHeights[i]);
+			}
+		}
+	});
+
+	if (!m_cullHeightOctaves)
+		m_heightField.EndUpdate();
+	m_moistureField.EndUpdate();
+}
+
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::RunTempuratureStage()
+{
+	m_tempuratureValues.resize(m_heightValues.size());
 
-		const float heightNoise = GetHeightNoise(gridPoint);
-		const float moistureNoise = GetMoistureNoise(gridPoint);
-		const float tempuratureNormal = GetTempuratureNormal(gridPoint);
+	ForEachRows(kTempuratureStage, kPassRowsPerJob, [this](size_t firstRow, size_t endRow, ThreadScratch&)
+	{
+		for (size_t row = firstRow; row < endRow; ++row)
+		{
+			const size_t rowStartIndex = row * m_mapWidth;
+			const float tempuratureNormal = GetTempuratureNormal(GetWorldRow(row));
 
-		const float heightValue = CalculateHeightValue(heightNoise);
-		const float tempValue = CalculateTempuratureValue(tempuratureNormal, heightValue);
-		const float moistureValue = CalculateMoistureValue(moistureNoise, tempValue, heightValue);
+			for (size_t i = rowStartIndex; i < rowStartIndex + m_mapWidth; ++i)
+			{
+				m_tempuratureValues[i] = CalculateTempuratureValue(tempuratureNormal, m_heightValues[i]);
+			}
+		}
+	});
+}
 
-		CalculateBiome(map, gridPoint, heightValue, tempValue, moistureValue);
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::RunMoistureStage()
+{
+	m_moistureValues.resize(m_heightValues.size());
 
-		SaltFlora(map, gridPoint);
+	ForEachRows(kMoistureStage, kRowsPerJob, [this](size_t firstRow, size_t endRow, ThreadScratch& scratch)
+	{
+		for (size_t row = firstRow; row < endRow; ++row)
+		{
+			const size_t rowStartIndex = row * m_mapWidth;
+			float* pMoistures = m_moistureValues.data() + rowStartIndex;
+
+			// Nothing to generate if the height stage ran, it generated these octaves along with its own.
+			GenerateNoiseRow(scratch.m_fieldCache, rowStartIndex, m_mapWidth);
+			GetMoistureNoiseRow(rowStartIndex, m_mapWidth, pMoistures);
+
+			for (size_t i = 0; i < m_mapWidth; ++i)
+			{
+				pMoistures[i] = CalculateMoistureValue(pMoistures[i], m_tempuratureValues[rowStartIndex + i], m_heightValues[rowStartIndex + i]);
+			}
+		}
+	});
+
+	m_moistureField.EndUpdate();
+}
+
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::RunBiomeStage()
+{
+	m_classifiedBiomes.resize(m_heightValues.size());
+
+	ForEachRows(kBiomeStage, kPassRowsPerJob, [this](size_t firstRow, size_t endRow, ThreadScratch&)
+	{
+		for (size_t i = firstRow * m_mapWidth; i < endRow * m_mapWidth; ++i)
+		{
+			m_classifiedBiomes[i] = CalculateBiome(m_heightValues[i], m_tempuratureValues[i], m_moistureValues[i]);
+		}
+	});
+}
+
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::RunSaltStage()
+{
+	m_saltedBiomes.resize(m_classifiedBiomes.size());
+
+	ForEachRows(kSaltStage, kPassRowsPerJob, [this](size_t firstRow, size_t endRow, ThreadScratch& scratch)
+	{
+		const Exelius::TileRandom saltRandom = m_tileRandom.GetStage(kSaltRandomStage);
+
+		for (size_t row = firstRow; row < endRow; ++row)
+		{
+			const size_t rowStartIndex = row * m_mapWidth;
+			float* pChances = scratch.m_saltChanceRow.data();
+
+			if (m_tileStep == 1)
+			{
+				saltRandom.GetFloats(GetWorldIndex(rowStartIndex), pChances, m_mapWidth);
+			}
+			else
+			{
+				for (size_t i = 0; i < m_mapWidth; ++i)
+				{
+					pChances[i] = saltRandom.GetFloat(GetWorldIndex(rowStartIndex + i));
+				}
+			}
+
+			for (size_t i = 0; i < m_mapWidth; ++i)
+			{
+				m_saltedBiomes[rowStartIndex + i] = SaltFlora(m_classifiedBiomes[rowStartIndex + i], pChances[i]);
+			}
+		}
+	});
+}
+
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::RunFloraStage()
+{
+	m_grownBiomes = m_saltedBiomes;
+
+	m_floraAutomaton.BeginSteps(m_grownBiomes, m_mapWidth, m_mapHeight, kRowsPerJob,
+		[this](const BiomeId* pAbove, const BiomeId* pRow, const BiomeId* pBelow, size_t row, size_t column)
+	{
+		return CanFloraGrow(pAbove, pRow, pBelow, row, column);
+	});
+
+	// Flora spreads a map tile per iteration, so a coarse map needs fewer to cover the same part of the world.
+	const int numGrowIterations = (kNumCellularAutomataIterations + (int)m_tileStep - 1) / (int)m_tileStep;
+	for (int i = 0; i < numGrowIterations; ++i)
+	{
+		GrowFlora(m_tileRandom.GetStage(kGrowFloraRandomStage + (unsigned int)i));
 	}
 }
 
-float WorldGenerator::GetHeightNoise(Exelius::Vector2f gridPoint)
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::GenerateNoiseRow(typename NoiseBackend::RowCache& cache, size_t rowStartIndex, size_t count)
 {
-	float heightNoise = m_noise.GetAverageNoise(gridPoint.x, gridPoint.y,
-		(float)m_mapWidth / kHeightNoiseDivisor, (float)m_mapHeight / kHeightNoiseDivisor,
-		m_heightParameters.GetInputRange(), m_heightParameters.GetOctaves(), m_heightParameters.GetPersistance(), m_heightParameters.GetSeed());
+	Exelius::NoiseField<NoiseBackend>* fields[2];
+	size_t numFields = 0;
+
+	if (!m_cullHeightOctaves && m_heightField.NeedsGeneration())
+		fields[numFields++] = &m_heightField;
+	if (m_moistureField.NeedsGeneration())
+		fields[numFields++] = &m_moistureField;
+
+	Exelius::NoiseField<NoiseBackend>::GenerateSpans(cache, fields, numFields, rowStartIndex, count);
+}
+
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::GetHeightNoiseRow(size_t rowStartIndex, size_t count, float* pOutNoise)
+{
+	m_heightField.BlendSpan(rowStartIndex, count, m_heightParameters.GetOctaves(), m_heightParameters.GetPersistance(), pOutNoise);
+	m_pHeightFalloff->ApplySpan(GetWorldIndex(rowStartIndex), count, pOutNoise, m_tileStep);
+}
+
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::GetCulledHeightNoiseRow(typename NoiseBackend::RowCache& cache, Exelius::OctaveCuller<NoiseBackend>& culler,
+	size_t rowStartIndex, size_t count, float* pFalloffScratch, float* pOutNoise)
+{
+	// Same product ApplySpan uses, so the culler classifies the exact height the tile ends up with.
+	const size_t row = GetWorldRow(rowStartIndex / m_mapWidth);
+	const size_t firstColumn = m_originColumn + (rowStartIndex % m_mapWidth) * m_tileStep;
+	const float rowFactor = m_pHeightFalloff->GetRowFactor(row);
+	for (size_t i = 0; i < count; ++i)
+	{
+		pFalloffScratch[i] = rowFactor * m_pHeightFalloff->GetColumnFactor(firstColumn + i * m_tileStep);
+	}
+
+	// World position of the first tile, like TileMap::GetTilePosition on the whole world.
+	const Exelius::Vector2f rowStartPoint = { (float)(firstColumn * m_tileWidth), (float)(row * m_tileHeight) };
+	culler.GetAverageNoiseRow(cache, rowStartPoint.x, (float)(m_tileWidth * m_tileStep), rowStartPoint.y, pOutNoise, count,
+		kNoiseWorldWidth / kHeightNoiseDivisor, kNoiseWorldHeight / kHeightNoiseDivisor,
+		m_heightParameters.GetInputRange(), m_heightParameters.GetOctaves(), m_heightParameters.GetPersistance(), m_heightParameters.GetSeed(),
+		pFalloffScratch, [this](float heightNoise) { return GetHeightBand(CalculateHeightValue(heightNoise)); });
 
-	return (heightNoise * powf(sinf(Exelius::PI * (gridPoint.y / (float)m_mapHeight)) * sinf(Exelius::PI * (gridPoint.x / (float)m_mapWidth)), kHeightNoiseExponent));
+	for (size_t i = 0; i < count; ++i)
+	{
+		pOutNoise[i] *= pFalloffScratch[i];
+	}
 }
 
-float WorldGenerator::GetMoistureNoise(Exelius::Vector2f gridPoint)
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::GetMoistureNoiseRow(size_t rowStartIndex, size_t count, float* pOutNoise)
 {
-	return m_noise.GetAverageNoise(gridPoint.x, gridPoint.y,
-		(float)m_mapWidth, (float)m_mapHeight,
-		m_moistureParameters.GetInputRange(), m_moistureParameters.GetOctaves(), m_moistureParameters.GetPersistance(), m_moistureParameters.GetSeed());
+	m_moistureField.BlendSpan(rowStartIndex, count, m_moistureParameters.GetOctaves(), m_moistureParameters.GetPersistance(), pOutNoise);
 }
 
-float WorldGenerator::GetTempuratureNormal(Exelius::Vector2f gridPoint)
+template <class NoiseBackend>
+float WorldGenerator<NoiseBackend>::GetTempuratureNormal(size_t row) const
 {
 	return (kDefaultPoleTempuratureNormal + (kDefaultEquatorTempuratureNormal - kDefaultPoleTempuratureNormal)
-		* powf(sinf(Exelius::PI * (gridPoint.y / (float)m_mapHeight)), kDefaultTempuratureFalloffExponent));
+		* m_pLatitudeFalloff->GetRowFactor(row));
 }
 
-float WorldGenerator::CalculateHeightValue(float heightNoise) const
+template <class NoiseBackend>
+float WorldGenerator<NoiseBackend>::CalculateHeightValue(float heightNoise) const
 {
 	return kMaxHeight * heightNoise;
 }
 
-float WorldGenerator::CalculateTempuratureValue(float tempMapVal, float heightValue) const
+template <class NoiseBackend>
+int WorldGenerator<NoiseBackend>::GetHeightBand(float heightValue)
+{
+	// Has to match the height checks at the top of BiomeTable::ClassifyBiome.
+	if (heightValue <= kOceanRange)
+		return 0;
+
+	if (heightValue <= kReefRange)
+		return 1;
+
+	if (heightValue >= kMountainRange)
+		return 2;
+
+	return -1;
+}
+
+template <class NoiseBackend>
+float WorldGenerator<NoiseBackend>::CalculateTempuratureValue(float tempMapVal, float heightValue) const
 {
 	// The conversion from height to tempurature is taken from this article by Lupe Tanner, PH.D.:
 	// https://www.enotes.com/homework-help/what-relationship-between-altitude-temperature-556362#
 	return (tempMapVal * kMaxTemp) + (heightValue / kHeightToTempDivisor) * kHeightToTempRateOfChange;
 }
 
-float WorldGenerator::CalculateMoistureValue(float moistureNoise, float tempValue, float heightValue) const
+template <class NoiseBackend>
+float WorldGenerator<NoiseBackend>::CalculateMoistureValue(float moistureNoise, float tempValue, float heightValue) const
 {
 	float moistureValue = 0.0f;
 	if (heightValue > kReefRange)
@@ -119,215 +440,165 @@ float WorldGenerator::CalculateMoistureValue(float moistureNoise, float tempValu
 	return moistureValue;
 }
 
-void WorldGenerator::CalculateBiome(TileMap& map, Exelius::Vector2f gridPoint, float heightValue, float tempValue, float moistureValue)
+template <class NoiseBackend>
+BiomeId WorldGenerator<NoiseBackend>::CalculateBiome(float heightValue, float tempValue, float moistureValue)
 {
-	if (heightValue <= kOceanRange)
-	{
-		map.SetTileColor(gridPoint, kOcean);
-		return;
-	}
-
-	if (heightValue <= kReefRange)
-	{
-		map.SetTileColor(gridPoint, kReef);
-		return;
-	}
-
-	if (heightValue >= kMountainRange)
-	{
-		map.SetTileColor(gridPoint, kRock);
-		return;
-	}
-
-	//The tempurature range is under -5 C
-	if (tempValue <= kTundraRange)
-	{
-		map.SetTileColor(gridPoint, kGlacier);
-		return;
-	}
-
-	//The tempurature range is under 0 C
-	else if (tempValue <= kTaigaRange)
-	{
-		if (moistureValue <= kSnowMoisture)
-			map.SetTileColor(gridPoint, kSnow);
-		else
-			map.SetTileColor(gridPoint, kGrassland);
-		return;
-	}
-
-	//The tempurature range is under 18 C
-	else if (tempValue <= kTemperateRange)
-	{
-		if (moistureValue <= kSavannaMoisture)
-			map.SetTileColor(gridPoint, kSavanna);
-		else if (moistureValue <= kGrasslandMoisture)
-			map.SetTileColor(gridPoint, kGrassland);
-		else
-			map.SetTileColor(gridPoint, kSwamp);
-		return;
-	}
-
-	//The tempurature range is under 30 C
-	else if (tempValue <= kTropicalRange)
-	{
-		if (moistureValue <= kDuneMoisture)
-			map.SetTileColor(gridPoint, kDunes);
-		else
-			map.SetTileColor(gridPoint, kDesert);
-		return;
-	}
-
-	map.SetTileColor(gridPoint, kError);
+	return BiomeTable::GetBiome(heightValue, tempValue, moistureValue);
 }
 
-void WorldGenerator::SaltFlora(TileMap& map, Exelius::Vector2f gridPoint)
+template <class NoiseBackend>
+BiomeId WorldGenerator<NoiseBackend>::SaltFlora(BiomeId biome, float chance)
 {
-	const float chance = m_rand.FRandomRange(0.0f, 1.0f);
-
-	if (map.GetTileColor(gridPoint) == kGrassland.GetHex())
+	if (biome == BiomeId::kGrassland)
 	{
 		if (chance <= kSaltGrassToRockChance)
-			map.SetTileColor(gridPoint, kRock);
+			return BiomeId::kRock;
 		else if (chance <= kSaltGrassToTreeChance)
-			map.SetTileColor(gridPoint, kForest);
+			return BiomeId::kForest;
 	}
 
-	else if (map.GetTileColor(gridPoint) == kSavanna.GetHex())
+	else if (biome == BiomeId::kSavanna)
 	{
 		if (chance <= kSaltSavannaToRockChance)
-			map.SetTileColor(gridPoint, kRock);
+			return BiomeId::kRock;
 		else if (chance <= kSaltSavannaToCliffChance)
-			map.SetTileColor(gridPoint, kCliff);
+			return BiomeId::kCliff;
 	}
 
-	else if (map.GetTileColor(gridPoint) == kSnow.GetHex())
+	else if (biome == BiomeId::kSnow)
 	{
 		if (chance <= kSaltSnowtoRockChance)
-			map.SetTileColor(gridPoint, kRock);
+			return BiomeId::kRock;
 		else if (chance <= kSaltSnowtoTreeChance)
-			map.SetTileColor(gridPoint, kCliff);
+			return BiomeId::kCliff;
 	}
 
-	else if (map.GetTileColor(gridPoint) == kDesert.GetHex())
+	else if (biome == BiomeId::kDesert)
 	{
 		if (chance <= kSaltDesertToRockChance)
-			map.SetTileColor(gridPoint, kRock);
+			return BiomeId::kRock;
 	}
 
-	else if (map.GetTileColor(gridPoint) == kGlacier.GetHex())
+	else if (biome == BiomeId::kGlacier)
 	{
 		if (chance <= kSaltGlacierToRockChance)
-			map.SetTileColor(gridPoint, kRock);
+			return BiomeId::kRock;
 	}
 
-	else if (map.GetTileColor(gridPoint) == kSwamp.GetHex())
+	else if (biome == BiomeId::kSwamp)
 	{
 		if (chance <= kSaltSwamptoRockChance)
-			map.SetTileColor(gridPoint, kRock);
+			return BiomeId::kRock;
 	}
+
+	return biome;
 }
 
-void WorldGenerator::GrowFlora(TileMap& map)
+template <class NoiseBackend>
+void WorldGenerator<NoiseBackend>::GrowFlora(const Exelius::TileRandom& random)
 {
-	for (size_t i = 0; i < map.GetTiles().size(); ++i)
+	EXELIUS_TRACE_SCOPE("Flora step");
+	m_floraAutomaton.Step(m_grownBiomes, m_mapWidth, m_mapHeight, kFloraTilesPerJob,
+		[this](const BiomeId* pAbove, const BiomeId* pRow, const BiomeId* pBelow, size_t row, size_t column)
 	{
-		if (map.GetTileColor(i) == kOcean.GetHex())
-			continue;
-
-		if (map.GetTileColor(i) == kForest.GetHex())
-		{
-			TryGrowForest(map, i);
-		}
-		else if (map.GetTileColor(i) == kRock.GetHex())
-		{
-			TryGrowRock(map, i);
-		}
-		else if (map.GetTileColor(i) == kCliff.GetHex())
-		{
-			TryGrowCliff(map, i);
-		}
-	}
+		return CanFloraGrow(pAbove, pRow, pBelow, row, column);
+	},
+		[this, &random](const BiomeId* pAbove, const BiomeId* pRow, const BiomeId* pBelow, size_t row, size_t column)
+	{
+		return GetGrownTile(pAbove, pRow, pBelow, row, column, random);
+	});
 }
 
-void WorldGenerator::TryGrowForest(TileMap& map, size_t index)
+template <class NoiseBackend>
+bool WorldGenerator<NoiseBackend>::CanFloraGrow(const BiomeId* pAbove, const BiomeId* pRow, const BiomeId* pBelow, size_t row, size_t column) const
 {
-	// This tile is a tree
-	const auto& neighbors = map.GetTileNeighbors(index);
+	const Exelius::GridStencil<BiomeId> tile(pAbove, pRow, pBelow, m_mapWidth, row, column);
+	const BiomeId biome = tile.GetCenter();
 
-	for (auto tile : neighbors)
-	{
-		const float chance = m_rand.FRandomRange(0.0f, 1.0f);
+	return (tile.HasTop() && CanSpreadFlora(tile.GetTop(), biome))
+		|| (tile.HasLeft() && CanSpreadFlora(tile.GetLeft(), biome))
+		|| (tile.HasRight() && CanSpreadFlora(tile.GetRight(), biome))
+		|| (tile.HasBottom() && CanSpreadFlora(tile.GetBottom(), biome));
+}
 
-		if (chance > kForestGrowthChance)
-			continue;
-		if (map.GetTileColor(tile) == kOcean.GetHex())
-			continue;
+template <class NoiseBackend>
+BiomeId WorldGenerator<NoiseBackend>::GetGrownTile(const BiomeId* pAbove, const BiomeId* pRow, const BiomeId* pBelow, size_t row, size_t column,
+	const Exelius::TileRandom& random) const
+{
+	const Exelius::GridStencil<BiomeId> tile(pAbove, pRow, pBelow, m_mapWidth, row, column);
+	const BiomeId biome = tile.GetCenter();
 
-		// This tile is a grass tile and it is going to become a tree
-		if (chance <= kForestGrowthChance && map.GetTileColor(tile) == kGrassland.GetHex())
-		{
-			map.SetTileColor(tile, kForest);
-		}
-		else if (chance <= kForestGrowthChance && map.GetTileColor(tile) == kSnow.GetHex())
-		{
-			map.SetTileColor(tile, kForest);
-		}
+	// Most tiles can't be grown over, no need to look at their neighbours.
+	if (biome != BiomeId::kGrassland && biome != BiomeId::kSnow && biome != BiomeId::kSavanna
+		&& biome != BiomeId::kDesert && biome != BiomeId::kGlacier && biome != BiomeId::kSwamp)
+	{
+		return biome;
 	}
+
+	// Neighbours in tile index order, a later one that spreads wins. Draws are keyed by world index.
+	const size_t index = GetWorldIndex(tile.GetIndex());
+	const size_t rowStride = (size_t)m_worldWidth * m_tileStep;
+	BiomeId result = biome;
+
+	if (tile.HasTop())
+		result = SpreadFlora(tile.GetTop(), index - rowStride, kBottomNeighbor, biome, result, random);
+	if (tile.HasLeft())
+		result = SpreadFlora(tile.GetLeft(), index - m_tileStep, kRightNeighbor, biome, result, random);
+	if (tile.HasRight())
+		result = SpreadFlora(tile.GetRight(), index + m_tileStep, kLeftNeighbor, biome, result, random);
+	if (tile.HasBottom())
+		result = SpreadFlora(tile.GetBottom(), index + rowStride, kTopNeighbor, biome, result, random);
+
+	return result;
 }
 
-void WorldGenerator::TryGrowRock(TileMap& map, size_t index)
+template <class NoiseBackend>
+BiomeId WorldGenerator<NoiseBackend>::SpreadFlora(BiomeId source, size_t sourceIndex, unsigned int slot, BiomeId target, BiomeId current,
+	const Exelius::TileRandom& random)
 {
-	const auto& neighbors = map.GetTileNeighbors(index);
-	const float chance = m_rand.FRandomRange(0.0f, 1.0f);
-	if (chance > kRockGrowthChance)
-		return;
+	// Forests draw once per neighbour and grow onto grass and snow.
+	if (source == BiomeId::kForest)
+	{
+		if ((target == BiomeId::kGrassland || target == BiomeId::kSnow) && random.GetFloat(sourceIndex, slot) <= kForestGrowthChance)
+			return BiomeId::kForest;
+	}
 
-	for (auto tile : neighbors)
+	// Rocks draw once per tile and grow onto every land biome.
+	else if (source == BiomeId::kRock)
 	{
-		if (map.GetTileColor(tile) == kOcean.GetHex())
-			continue;
+		if (random.GetFloat(sourceIndex) <= kRockGrowthChance)
+			return BiomeId::kRock;
+	}
 
-		if (map.GetTileColor(tile) == kGrassland.GetHex())
-		{
-			map.SetTileColor(tile, kRock);
-		}
-		else if (map.GetTileColor(tile) == kDesert.GetHex())
-		{
-			map.SetTileColor(tile, kRock);
-		}
-		else if (map.GetTileColor(tile) == kGlacier.GetHex())
-		{
-			map.SetTileColor(tile, kRock);
-		}
-		else if (map.GetTileColor(tile) == kSavanna.GetHex())
-		{
-			map.SetTileColor(tile, kRock);
-		}
-		else if (map.GetTileColor(tile) == kSwamp.GetHex())
-		{
-			map.SetTileColor(tile, kRock);
-		}
-		else if (map.GetTileColor(tile) == kSnow.GetHex())
-		{
-			map.SetTileColor(tile, kRock);
-		}
+	// Cliffs draw once per tile and grow onto savanna.
+	else if (source == BiomeId::kCliff)
+	{
+		if (target == BiomeId::kSavanna && random.GetFloat(sourceIndex) <= kCliffGrowthChance)
+			return BiomeId::kCliff;
 	}
+
+	return current;
 }
 
-void WorldGenerator::TryGrowCliff(TileMap& map, size_t index)
+template <class NoiseBackend>
+bool WorldGenerator<NoiseBackend>::CanSpreadFlora(BiomeId source, BiomeId target)
 {
-	const auto& neighbors = map.GetTileNeighbors(index);
-	const float chance = m_rand.FRandomRange(0.0f, 1.0f);
-
-	if (chance > kCliffGrowthChance)
-		return;
+	// Same cases as SpreadFlora.
+	if (source == BiomeId::kForest)
+		return target == BiomeId::kGrassland || target == BiomeId::kSnow;
 
-	for (auto tile : neighbors)
+	if (source == BiomeId::kRock)
 	{
-		if (map.GetTileColor(tile) == kSavanna.GetHex())
-		{
-			map.SetTileColor(tile, kCliff);
-		}
+		return target == BiomeId::kGrassland || target == BiomeId::kSnow || target == BiomeId::kSavanna
+			|| target == BiomeId::kDesert || target == BiomeId::kGlacier || target == BiomeId::kSwamp;
 	}
-}
\ No newline at end of file
+
+	if (source == BiomeId::kCliff)
+		return target == BiomeId::kSavanna;
+
+	return false;
+}
+
+// The generator is only ever built against these backends, so the definitions can stay out of the header.
+template class WorldGenerator<Exelius::PerlinNoise>;
+template class WorldGenerator<Exelius::SimplexNoise>;
\ No newline at end of file
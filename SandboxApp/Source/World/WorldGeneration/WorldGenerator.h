@@ -1,11 +1,36 @@
 #pragma once
+#include "World/GenertionSettings/BiomeTable.h"
 #include "World/GenertionSettings/NoiseParameters.h"
+#include "World/Masks/FalloffTable.h"
 #include "World/TileMap/TileMap.h"
+#include <Utilities/CellularAutomaton.h>
+#include <Utilities/GridNeighborhood.h>
+#include <Utilities/JobSystem.h>
+#include <Utilities/StagePipeline.h>
+#include <Utilities/TraceRecorder.h>
+#include <Utilities/Random/Noise/NoiseField.h>
+#include <Utilities/Random/Noise/OctaveCuller.h>
 #include <Utilities/Random/Noise/PerlinNoise.h>
+#include <Utilities/Random/Noise/SimplexNoise.h>
+#include <Utilities/Random/Noise/SquirrelNoise.h>
 #include <Utilities/Random/Random.h>
+#include <Utilities/Random/TileRandom.h>
 
-#include <array>
-#include <thread>
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// Wall-clock seconds the last GenerateWorld spent in each part of the pipeline. Noise is the height and
+/// moisture stages, biome the tempurature and biome stages. Stages that reused their cached output count 0.
+/// </summary>
+struct WorldGenerationTimings
+{
+	double m_noiseSeconds = 0.0;
+	double m_biomeSeconds = 0.0;
+	double m_saltSeconds = 0.0;
+	double m_growFloraSeconds = 0.0;
+	double m_totalSeconds = 0.0;
+};
 
 /// <summary>
 /// Generates the terrain/map of the world.
@@ -18,24 +43,141 @@
 ///		The tempurature is a Perlin Noise gradient with a low input range
 ///		because the "equator" of this world is random and should generate
 ///		unique "poles".
+/// Noise:
+///		NoiseBackend is the noise type every map is generated with,
+///		Exelius::PerlinNoise or Exelius::SimplexNoise. It is a compile
+///		time choice so the per-pixel noise calls are direct calls.
+/// Pipeline:
+///		Generation is a chain of stages (see PipelineStage), each making one
+///		plane of the map from the planes of the stages before it. Every plane
+///		is kept, keyed by the parameters and inputs it was made from, and a
+///		stage only runs again when that key changes. Changing the moisture
+///		parameters reruns moisture, biome, salt and flora, and reuses the
+///		height and tempurature planes.
 /// </summary>
+template <class NoiseBackend>
 class WorldGenerator
 {
-	static constexpr unsigned int kMaxThreads = 7;
-	std::thread* m_pThreadPool = nullptr;
+public:
+	/// <summary>
+	/// The stages of the generation pipeline, in run order, and the planes they make:
+	///		Height:			interpreted height per tile (float), from the height noise and falloff.
+	///		Tempurature:	tempurature per tile (float), from latitude and height.
+	///		Moisture:		moisture per tile (float), from the moisture noise, tempurature and height.
+	///		Biome:			biome per tile, from height, tempurature and moisture.
+	///		Salt:			the biomes with rock, forest and cliff seeds scattered over them.
+	///		Flora:			the salted biomes after flora growth, what the map gets.
+	/// </summary>
+	enum PipelineStage : size_t
+	{
+		kHeightStage,
+		kTempuratureStage,
+		kMoistureStage,
+		kBiomeStage,
+		kSaltStage,
+		kFloraStage,
+
+		kNumPipelineStages
+	};
+
+private:
+	// Rows per job system job. Small enough that rows with more work to do don't hold up the rest of
+	// the map, large enough that a job is still mostly noise evaluation.
+	static constexpr size_t kRowsPerJob = 4;
+
+	// Active tiles per job of a flora growth iteration.
+	static constexpr size_t kFloraTilesPerJob = 1024;
+
+	// Rows per job of the stages that do a little math per tile (tempurature, biome, salt).
+	static constexpr size_t kPassRowsPerJob = 16;
+
+	/// <summary>
+	/// Scratch for one job system thread. Noise is evaluated a row at a time through the batch API, so each
+	/// thread keeps a row of scratch and its own lattice gradient caches (one for the fused field rows, one
+	/// for the culler).
+	/// </summary>
+	struct ThreadScratch
+	{
+		std::vector<float> m_saltChanceRow;
+		std::vector<float> m_falloffRow;
+		typename NoiseBackend::RowCache m_fieldCache;
+		typename NoiseBackend::RowCache m_cullerCache;
+		Exelius::OctaveCuller<NoiseBackend> m_heightCuller;
+	};
 
-	Exelius::PerlinNoise m_noise;
 	Exelius::Random m_rand;
 
+	// Per-octave noise planes. Changing only persistance or octave count re-blends these instead of
+	// evaluating the noise again. Missing octaves of every channel are generated together, so another
+	// fBm channel (e.g. tempurature noise) only needs its own field here and a slot in GenerateNoiseRow.
+	Exelius::NoiseField<NoiseBackend> m_heightField;
+	Exelius::NoiseField<NoiseBackend> m_moistureField;
+
 	unsigned int m_mapWidth;
 	unsigned int m_mapHeight;
+	unsigned int m_tileWidth;
+	unsigned int m_tileHeight;
+
+	// The map being generated is the window at (m_originColumn, m_originRow) of a m_worldWidth x m_worldHeight
+	// world. Noise, masks and per-tile random draws all use world coordinates, so a tile comes out the same
+	// whichever window it is generated in.
+	unsigned int m_worldWidth;
+	unsigned int m_worldHeight;
+	unsigned int m_originColumn;
+	unsigned int m_originRow;
+
+	// World tiles between two map tiles. A map generated with a step above 1 is a coarse preview of the
+	// world: it samples every m_tileStep-th world tile, and flora growth runs fewer iterations to match.
+	unsigned int m_tileStep;
+
+	// Shared per-map-size masks: the island falloff on the height noise, and the latitude curve
+	// (row factors only) the tempurature gradient follows.
+	std::shared_ptr<const FalloffTable> m_pHeightFalloff;
+	std::shared_ptr<const FalloffTable> m_pLatitudeFalloff;
+
+	// When set, height noise skips the fine octaves of tiles that are already known to end up ocean, reef
+	// or mountain. Skips m_heightField, so it only pays off when every generation uses new settings.
+	bool m_cullHeightOctaves;
+
+	// Stages of m_tileRandom. Every flora growth iteration gets its own stage, kGrowFloraRandomStage + iteration.
+	static constexpr unsigned int kSaltRandomStage = 0;
+	static constexpr unsigned int kGrowFloraRandomStage = 1;
+
+	// A tile's place in the neighbor list of TileMap::GetTileNeighbors.
+	static constexpr unsigned int kLeftNeighbor = 0;
+	static constexpr unsigned int kRightNeighbor = 1;
+	static constexpr unsigned int kTopNeighbor = 2;
+	static constexpr unsigned int kBottomNeighbor = 3;
+
+	// Salting and flora growth draw per tile from this (seeded with the noise in ResetGenerator), so the
+	// result does not depend on which thread handles which tile, or which window it is generated in.
+	// m_rand is only used on the calling thread.
+	Exelius::TileRandom m_tileRandom;
+
+	// Active tiles of flora growth. Only tiles next to forest, rock or cliff can grow, a small part of most maps.
+	Exelius::SparseCellularAutomaton<BiomeId> m_floraAutomaton;
+
+	// Decides which stages run, see PipelineStage. Every stage's plane below is kept for the next generation.
+	Exelius::StagePipeline m_pipeline;
+	std::vector<float> m_heightValues;
+	std::vector<float> m_tempuratureValues;
+	std::vector<float> m_moistureValues;
+	std::vector<BiomeId> m_classifiedBiomes;
+	std::vector<BiomeId> m_saltedBiomes;
+	std::vector<BiomeId> m_grownBiomes;
+
+	// One per job system thread, indexed by JobSystem::GetCurrentThreadIndex.
+	std::vector<ThreadScratch> m_threadScratch;
+	WorldGenerationTimings m_lastTimings;
 	
 public:
 	NoiseParameters m_heightParameters;
 	NoiseParameters m_moistureParameters;
 
-	WorldGenerator();
-	~WorldGenerator();
+	/// <summary>
+	/// seed drives every noise seed the generator picks. 0 seeds from the clock, like Exelius::Random.
+	/// </summary>
+	WorldGenerator(unsigned long long seed = 0);
 
 	WorldGenerator(const WorldGenerator&) = default;
 	WorldGenerator(WorldGenerator&&) = default;
@@ -44,29 +186,172 @@ public:
 
 	void ResetGenerator();
 
+	/// <summary>
+	/// Opt in to height octave culling. Tiles classify exactly as they would with every octave, but
+	/// persistance and octave count changes are no longer re-blended from cached octaves.
+	///
+	/// Ocean, reef and mountain tiles are classified from their height alone, so the culler can stop their
+	/// sum once the band is certain. Their Height plane value may then be a partial height, in the right
+	/// band but not the exact value, and their Tempurature and Moisture are made from it. Every other
+	/// tile's planes are exact.
+	/// </summary>
+	void SetHeightOctaveCulling(bool cullHeightOctaves) { m_cullHeightOctaves = cullHeightOctaves; }
+
+	/// <summary>
+	/// Noise parameters of the height and moisture planes. Changes are picked up by the next GenerateWorld,
+	/// which only reruns the stages downstream of the plane that changed.
+	/// </summary>
+	NoiseParameters& GetHeightParameters() { return m_heightParameters; }
+	NoiseParameters& GetMoistureParameters() { return m_moistureParameters; }
+
 	/// <summary>
 	/// Generate the Terrain, Biomes, and Flora.
 	/// </summary>
 	void GenerateWorld(TileMap& map);
 
+	/// <summary>
+	/// Generate map as the window at (originColumn, originRow) of a worldWidth x worldHeight world, for
+	/// worlds that are too large to generate at once. A tile comes out as GenerateWorld on the whole world
+	/// would make it, except within kNumCellularAutomataIterations tiles of a window edge that is not a
+	/// world edge, where flora growth can't see the tiles past the edge.
+	/// The noise has the same detail per tile for every world size (kNoiseWorldWidth), only the island
+	/// falloff and the latitude are stretched over the whole world.
+	///
+	/// With a tileStep above 1, map tile (column, row) is world tile (originColumn + column * tileStep,
+	/// originRow + row * tileStep), a low resolution preview of the window. The origin must be a multiple of
+	/// tileStep, and map tiles must not land past the world edge.
+	/// </summary>
+	void GenerateRegion(TileMap& map, unsigned int worldWidth, unsigned int worldHeight, unsigned int originColumn, unsigned int originRow,
+		unsigned int tileStep = 1);
+
+	/// <summary>
+	/// Per-stage timings of the last GenerateWorld.
+	/// </summary>
+	const WorldGenerationTimings& GetLastTimings() const { return m_lastTimings; }
+
+	/// <summary>
+	/// The generation pipeline, for which stages the last GenerateWorld ran (indexed by PipelineStage).
+	/// </summary>
+	const Exelius::StagePipeline& GetPipeline() const { return m_pipeline; }
+
 private:
 
-	void GenerateWorldThread(TileMap& map, size_t startIndex, size_t endIndex);
+	/// <summary>
+	/// The world index (row * worldWidth + column) of a tile of the map being generated.
+	/// </summary>
+	size_t GetWorldIndex(size_t tileIndex) const
+	{
+		return GetWorldRow(tileIndex / m_mapWidth) * m_worldWidth + m_originColumn + (tileIndex % m_mapWidth) * m_tileStep;
+	}
+
+	size_t GetWorldRow(size_t row) const { return m_originRow + row * m_tileStep; }
 
-	float GetHeightNoise(Exelius::Vector2f gridPoint);
-	float GetMoistureNoise(Exelius::Vector2f gridPoint);
-	float GetTempuratureNormal(Exelius::Vector2f gridPoint);
+	/// <summary>
+	/// Add the parameters a stage's plane depends on, besides the planes it reads, to its key.
+	/// </summary>
+	void AddStageParameters(size_t stage, Exelius::StageKey& key) const;
+
+	void RunStage(size_t stage);
+
+	/// <summary>
+	/// Run function(firstRow, endRow, scratch) over every map row on the job system. Every job is traced
+	/// under the stage's name.
+	/// </summary>
+	template <class Function>
+	void ForEachRows(size_t stage, size_t rowsPerJob, const Function& function);
+
+	/// <summary>
+	/// The interpreted height of every tile. Also generates the moisture octaves the moisture stage will
+	/// blend, in the same fused pass as the height octaves.
+	/// </summary>
+	void RunHeightStage();
+
+	void RunTempuratureStage();
+	void RunMoistureStage();
+	void RunBiomeStage();
+	void RunSaltStage();
+	void RunFloraStage();
+
+	/// <summary>
+	/// Generate the missing octaves of every noise field for count tiles along a row, starting at tile
+	/// rowStartIndex, in one fused pass. m_heightField is left out in culling mode.
+	/// </summary>
+	void GenerateNoiseRow(typename NoiseBackend::RowCache& cache, size_t rowStartIndex, size_t count);
+
+	/// <summary>
+	/// Fill count height noise values along a row, starting at tile rowStartIndex.
+	/// Blends the cached octaves of m_heightField and masks them with m_pHeightFalloff.
+	/// </summary>
+	void GetHeightNoiseRow(size_t rowStartIndex, size_t count, float* pOutNoise);
+
+	/// <summary>
+	/// GetHeightNoiseRow for culling mode. Evaluates the height noise directly, stopping early for tiles
+	/// whose band (see GetHeightBand) can no longer change. pFalloffScratch holds count floats.
+	/// </summary>
+	void GetCulledHeightNoiseRow(typename NoiseBackend::RowCache& cache, Exelius::OctaveCuller<NoiseBackend>& culler,
+		size_t rowStartIndex, size_t count, float* pFalloffScratch, float* pOutNoise);
+
+	/// <summary>
+	/// Fill count moisture noise values along a row, starting at tile rowStartIndex.
+	/// Blends the cached octaves of m_moistureField.
+	/// </summary>
+	void GetMoistureNoiseRow(size_t rowStartIndex, size_t count, float* pOutNoise);
+
+	/// <summary>
+	/// The tempurature gradient only depends on latitude, so it is one lookup per row. row is a world row.
+	/// </summary>
+	float GetTempuratureNormal(size_t row) const;
+
+	/// <summary>
+	/// The biome a tile is salted to: a rock, forest or cliff seed, or biome itself. chance is the tile's draw.
+	/// </summary>
+	static BiomeId SaltFlora(BiomeId biome, float chance);
+
+	/// <summary>
+	/// One cellular automata iteration of flora growth on m_grownBiomes. random is the stage for this iteration.
+	/// Forest, rock and cliff tiles spread to the neighbours they can grow on. Every tile is decided
+	/// from the map as it was before the iteration, in parallel over the job system. Only the active
+	/// tiles of m_floraAutomaton are visited, so m_floraAutomaton.BeginSteps has to run first.
+	/// </summary>
+	void GrowFlora(const Exelius::TileRandom& random);
 
-	//void SaltFloraMap(TileMap& map, size_t startIndex, size_t endIndex);
-	void SaltFlora(TileMap& map, Exelius::Vector2f gridPoint);
+	/// <summary>
+	/// True if flora can grow onto a tile: it has a neighbour that can spread to it. Arguments are like
+	/// GetGrownTile. GetGrownTile leaves every other tile as it is.
+	/// </summary>
+	bool CanFloraGrow(const BiomeId* pAbove, const BiomeId* pRow, const BiomeId* pBelow, size_t row, size_t column) const;
 
-	void GrowFlora(TileMap& map);
+	/// <summary>
+	/// The biome a tile has after one growth iteration. pAbove/pBelow are the rows around pRow (null at
+	/// the map edge), all from before the iteration.
+	/// </summary>
+	BiomeId GetGrownTile(const BiomeId* pAbove, const BiomeId* pRow, const BiomeId* pBelow, size_t row, size_t column,
+		const Exelius::TileRandom& random) const;
+
+	/// <summary>
+	/// What a source tile turns a target tile into if it spreads to it, or current if it doesn't.
+	/// slot is the target's place in the source's neighbor list (left, right, top, bottom), it picks
+	/// the forest draw.
+	/// </summary>
+	static BiomeId SpreadFlora(BiomeId source, size_t sourceIndex, unsigned int slot, BiomeId target, BiomeId current,
+		const Exelius::TileRandom& random);
+
+	/// <summary>
+	/// True if a source tile can spread to a target tile at all, before its growth chance is drawn.
+	/// </summary>
+	static bool CanSpreadFlora(BiomeId source, BiomeId target);
 
 	/// <summary>
 	/// Calculates the interpreted value of the height map.
 	/// </summary>
 	float CalculateHeightValue(float heightNoise) const;
 
+	/// <summary>
+	/// The band CalculateBiome puts a height value in when the height alone decides the biome
+	/// (ocean, reef, mountain), or -1 when the biome depends on the exact height.
+	/// </summary>
+	static int GetHeightBand(float heightValue);
+
 	/// <summary>
 	/// Calculates the interpreted value of the tempurature map.
 	/// This calculation is dependant on the *value* of the height noise.
@@ -82,14 +367,10 @@ private:
 	float CalculateMoistureValue(float moistureNoise, float tempValue, float heightValue) const;
 
 	/// <summary>
-	/// Set the color of a map tile color based on the values of the Height,
+	/// The biome of a tile based on the values of the Height,
 	/// Moisture, and Tempurature maps at the tiles position in the world.
+	/// The biome comes from BiomeTable, a lookup instead of a branch per threshold.
 	/// </summary>
-	void CalculateBiome(TileMap& map, Exelius::Vector2f gridPoint, float heightValue, float tempValue, float moistureValue);
-
-	void TryGrowForest(TileMap& map, size_t index);
-
-	void TryGrowRock(TileMap& map, size_t index);
+	static BiomeId CalculateBiome(float heightValue, float tempValue, float moistureValue);
 
-	void TryGrowCliff(TileMap& map, size_t index);
 };
\ No newline at end of file